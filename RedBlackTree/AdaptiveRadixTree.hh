@@ -0,0 +1,633 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef ADAPTIVE_RADIX_TREE_HH
+#define ADAPTIVE_RADIX_TREE_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "RedBlackTree.hh"
+
+// Completion of a prefix and the number of copies of that key
+struct Completion {
+   std::string key;
+   size_t count;
+};
+
+// Keeps the k most frequent completions offered to it. Offer keys in sorted order: on equal
+// counts the key offered first (the smaller one) is kept.
+class TopCompletions {
+private:
+   size_t k;
+   std::vector<Completion> heap;  // Least frequent kept completion on top
+
+   static bool better(const Completion& a, const Completion& b) {
+      return a.count > b.count || (a.count == b.count && a.key < b.key);
+   }
+
+public:
+   explicit TopCompletions(size_t k) : k(k) {}
+
+   // Whether a key seen count times can no longer get in (lets callers skip whole subtrees)
+   bool excludes(size_t count) const {
+      return heap.size() == k && (k == 0 || count <= heap.front().count);
+   }
+
+   void offer(const std::string& key, size_t count) {
+      if (excludes(count)) return;
+
+      if (heap.size() == k) {
+         std::pop_heap(heap.begin(), heap.end(), better);
+         heap.pop_back();
+      }
+      heap.push_back(Completion{key, count});
+      std::push_heap(heap.begin(), heap.end(), better);
+   }
+
+   // Most frequent first
+   std::vector<Completion> take() {
+      std::sort_heap(heap.begin(), heap.end(), better);
+      return std::move(heap);
+   }
+};
+
+// Adaptive radix tree (ART) over std::string keys, meant as a prefix index next to a string tree.
+// Inner nodes grow from 4 to 16, 48 and 256 children as needed, and runs of single-child nodes
+// are collapsed into a stored prefix (path compression), so a lookup costs O(key length)
+// whatever the number of keys. Duplicates are counted rather than stored twice, and every node
+// keeps the number of keys below it, which makes countPrefix() a single descent.
+// Bytes are compared as unsigned char, the same order std::string::compare() uses.
+class AdaptiveRadixTree {
+private:
+   enum Kind : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+   struct ArtNode {
+      Kind kind;
+      uint16_t children;   // Number of child pointers in use
+      std::string prefix;  // Compressed path between the parent's edge byte and this node
+      size_t terminal;     // Keys ending exactly here (duplicates included)
+      size_t total;        // Keys ending in this subtree, terminal included
+
+      explicit ArtNode(Kind kind) : kind(kind), children(0), terminal(0), total(0) {}
+   };
+
+   struct Node4 : ArtNode {
+      unsigned char keys[4];  // Sorted edge bytes
+      ArtNode* child[4];
+      Node4() : ArtNode(NODE4) {}
+   };
+
+   struct Node16 : ArtNode {
+      unsigned char keys[16];
+      ArtNode* child[16];
+      Node16() : ArtNode(NODE16) {}
+   };
+
+   struct Node48 : ArtNode {
+      unsigned char index[256];  // Edge byte -> slot + 1 (0 = no child)
+      ArtNode* child[48];
+      Node48() : ArtNode(NODE48) {
+         std::memset(index, 0, sizeof(index));
+         std::memset(child, 0, sizeof(child));
+      }
+   };
+
+   struct Node256 : ArtNode {
+      ArtNode* child[256];
+      Node256() : ArtNode(NODE256) { std::memset(child, 0, sizeof(child)); }
+   };
+
+   ArtNode* root;  // Never removed, prefix always empty
+
+   static ArtNode** findChild(ArtNode* node, unsigned char byte);
+   static void addChild(ArtNode** slot, unsigned char byte, ArtNode* child);
+   static void removeChild(ArtNode* node, unsigned char byte);
+   void compress(ArtNode** slot);
+   static void moveHeader(ArtNode* to, ArtNode* from);
+   static void freeNode(ArtNode* node);
+   static void destroy(ArtNode* node);
+   static size_t nodeBytes(const ArtNode* node);
+
+   template<typename Callback>
+   static bool forEachChild(const ArtNode* node, Callback&& callback);
+
+   template<typename Visitor>
+   static bool walk(const ArtNode* node, std::string& key, Visitor& visit, size_t& remaining);
+   static void rank(const ArtNode* node, std::string& key, TopCompletions& top);
+
+   const ArtNode* locate(const std::string& prefix, std::string& path) const;
+
+public:
+   AdaptiveRadixTree() : root(new Node4()) {}
+   ~AdaptiveRadixTree() { destroy(root); }
+
+   AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+   AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+   // Core operations - O(key length)
+   void insert(const std::string& key);
+   bool remove(const std::string& key);  // Removes one copy
+   bool contains(const std::string& key) const { return count(key) != 0; }
+   size_t count(const std::string& key) const;
+
+   // Prefix queries: countPrefix() is O(|prefix|) and counts duplicates. visitPrefix() visits
+   // each distinct key once, in sorted order, at most limit of them, adding O(1) per key.
+   // topCompletions() ranks distinct keys by their number of copies, most frequent first; it
+   // skips every subtree holding fewer copies than the k-th best found so far.
+   size_t countPrefix(const std::string& prefix) const;
+   std::vector<Completion> topCompletions(const std::string& prefix, size_t k) const;
+
+   template<typename Visitor>
+   void visitPrefix(const std::string& prefix, Visitor&& visit,
+                    size_t limit = std::numeric_limits<size_t>::max()) const;
+
+   std::vector<std::string> prefixRange(const std::string& prefix,
+                                        size_t limit = std::numeric_limits<size_t>::max()) const;
+
+   // Utility operations
+   bool isEmpty() const { return root->total == 0; }
+   size_t size() const { return root->total; }
+   void clear();
+   size_t memoryBytes() const { return nodeBytes(root); }  // Nodes plus prefix heap
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// INSERT: Descend byte by byte, splitting a compressed prefix where the key leaves it
+inline void AdaptiveRadixTree::insert(const std::string& key) {
+   ArtNode** slot = &root;
+   size_t depth = 0;
+
+   while (true) {
+      ArtNode* node = *slot;
+
+      size_t matched = 0;
+      while (matched < node->prefix.size() && depth + matched < key.size() &&
+             node->prefix[matched] == key[depth + matched]) {
+         matched++;
+      }
+
+      // Key diverges (or ends) inside the prefix: a new parent takes the shared part
+      if (matched < node->prefix.size()) {
+         Node4* parent = new Node4();
+         parent->prefix = node->prefix.substr(0, matched);
+         parent->total = node->total;
+
+         const unsigned char edge = static_cast<unsigned char>(node->prefix[matched]);
+         node->prefix.erase(0, matched + 1);
+         parent->keys[0] = edge;
+         parent->child[0] = node;
+         parent->children = 1;
+
+         *slot = parent;
+         node = parent;
+      }
+
+      depth += matched;
+      node->total++;
+
+      if (depth == key.size()) {
+         node->terminal++;
+         return;
+      }
+
+      const unsigned char byte = static_cast<unsigned char>(key[depth]);
+      ArtNode** child = findChild(node, byte);
+      if (child == nullptr) {
+         // The rest of the key becomes the prefix of a single new leaf
+         Node4* leaf = new Node4();
+         leaf->prefix = key.substr(depth + 1);
+         leaf->terminal = 1;
+         leaf->total = 1;
+         addChild(slot, byte, leaf);
+         return;
+      }
+
+      slot = child;
+      depth++;
+   }
+}
+
+// DELETE: Decrement counts along the path, drop the subtree that became empty, re-compress
+inline bool AdaptiveRadixTree::remove(const std::string& key) {
+   if (count(key) == 0) return false;
+
+   ArtNode** slot = &root;
+   ArtNode** parentSlot = nullptr;
+   ArtNode** pruneSlot = nullptr;  // Slot of the parent of the topmost emptied node
+   unsigned char pruneByte = 0;
+   size_t depth = 0;
+
+   while (true) {
+      ArtNode* node = *slot;
+      node->total--;
+      if (node->total == 0 && pruneSlot == nullptr && parentSlot != nullptr) {
+         pruneSlot = parentSlot;
+         pruneByte = static_cast<unsigned char>(key[depth - 1]);
+      }
+
+      depth += node->prefix.size();
+      if (depth == key.size()) {
+         node->terminal--;
+         break;
+      }
+
+      parentSlot = slot;
+      slot = findChild(node, static_cast<unsigned char>(key[depth]));
+      depth++;
+   }
+
+   if (pruneSlot != nullptr) {
+      ArtNode* parent = *pruneSlot;
+      ArtNode* dead = *findChild(parent, pruneByte);
+      removeChild(parent, pruneByte);
+      destroy(dead);
+      compress(pruneSlot);
+   } else {
+      compress(slot);
+   }
+   return true;
+}
+
+// SEARCH: Number of copies of key
+inline size_t AdaptiveRadixTree::count(const std::string& key) const {
+   const ArtNode* node = root;
+   size_t depth = 0;
+
+   while (true) {
+      if (key.compare(depth, node->prefix.size(), node->prefix) != 0) return 0;
+
+      depth += node->prefix.size();
+      if (depth == key.size()) return node->terminal;
+
+      const unsigned char byte = static_cast<unsigned char>(key[depth]);
+      ArtNode** child = findChild(const_cast<ArtNode*>(node), byte);
+      if (child == nullptr) return 0;
+
+      node = *child;
+      depth++;
+   }
+}
+
+// SEARCH: Node whose subtree holds exactly the keys starting with prefix (nullptr if none).
+// path receives the full key prefix leading to that node, which may extend past prefix.
+inline const AdaptiveRadixTree::ArtNode* AdaptiveRadixTree::locate(const std::string& prefix,
+                                                                   std::string& path) const {
+   const ArtNode* node = root;
+   size_t depth = 0;
+   path.clear();
+
+   while (true) {
+      // The query may end part way through this node's compressed path
+      const size_t remaining = prefix.size() - depth;
+      const size_t length = remaining < node->prefix.size() ? remaining : node->prefix.size();
+      if (node->prefix.compare(0, length, prefix, depth, length) != 0) return nullptr;
+
+      path += node->prefix;
+      if (remaining <= node->prefix.size()) return node;
+
+      depth += node->prefix.size();
+      const unsigned char byte = static_cast<unsigned char>(prefix[depth]);
+      ArtNode** child = findChild(const_cast<ArtNode*>(node), byte);
+      if (child == nullptr) return nullptr;
+
+      path.push_back(prefix[depth]);
+      node = *child;
+      depth++;
+   }
+}
+
+// PREFIX QUERY: Subtree totals answer the count without visiting any key
+inline size_t AdaptiveRadixTree::countPrefix(const std::string& prefix) const {
+   std::string path;
+   const ArtNode* node = locate(prefix, path);
+   return node != nullptr ? node->total : 0;
+}
+
+template<typename Visitor>
+void AdaptiveRadixTree::visitPrefix(const std::string& prefix, Visitor&& visit,
+                                    size_t limit) const {
+   std::string key;
+   const ArtNode* node = locate(prefix, key);
+   if (node == nullptr || limit == 0) return;
+
+   walk(node, key, visit, limit);
+}
+
+inline std::vector<std::string> AdaptiveRadixTree::prefixRange(const std::string& prefix,
+                                                               size_t limit) const {
+   std::vector<std::string> result;
+   visitPrefix(prefix, [&result](const std::string& key) {
+      result.push_back(key);
+   }, limit);
+   return result;
+}
+
+// PREFIX HELPER: Preorder walk rebuilding keys in place; returns false once the limit is reached
+template<typename Visitor>
+bool AdaptiveRadixTree::walk(const ArtNode* node, std::string& key, Visitor& visit,
+                             size_t& remaining) {
+   // A key ending here sorts before every longer key below it; copies are visited once
+   if (node->terminal != 0) {
+      visit(static_cast<const std::string&>(key));
+      if (--remaining == 0) return false;
+   }
+
+   return forEachChild(node, [&](unsigned char byte, const ArtNode* child) {
+      const size_t length = key.size();
+      key.push_back(static_cast<char>(byte));
+      key += child->prefix;
+      const bool more = walk(child, key, visit, remaining);
+      key.resize(length);
+      return more;
+   });
+}
+
+// PREFIX QUERY: Most frequent completions; a subtree whose total cannot beat the current k-th
+// best holds no key that could
+inline std::vector<Completion> AdaptiveRadixTree::topCompletions(const std::string& prefix,
+                                                                 size_t k) const {
+   TopCompletions top(k);
+   std::string key;
+   const ArtNode* node = locate(prefix, key);
+   if (node != nullptr) {
+      rank(node, key, top);
+   }
+   return top.take();
+}
+
+// PREFIX HELPER: Preorder walk offering every distinct key with its number of copies
+inline void AdaptiveRadixTree::rank(const ArtNode* node, std::string& key, TopCompletions& top) {
+   if (top.excludes(node->total)) return;
+
+   if (node->terminal != 0) {
+      top.offer(key, node->terminal);
+   }
+
+   forEachChild(node, [&](unsigned char byte, const ArtNode* child) {
+      const size_t length = key.size();
+      key.push_back(static_cast<char>(byte));
+      key += child->prefix;
+      rank(child, key, top);
+      key.resize(length);
+      return true;
+   });
+}
+
+// UTILITY: Remove all keys (the empty root stays)
+inline void AdaptiveRadixTree::clear() {
+   destroy(root);
+   root = new Node4();
+}
+
+// CHILDREN: Slot holding the child for byte, or nullptr
+inline AdaptiveRadixTree::ArtNode** AdaptiveRadixTree::findChild(ArtNode* node,
+                                                                 unsigned char byte) {
+   switch (node->kind) {
+      case NODE4: {
+         Node4* n = static_cast<Node4*>(node);
+         for (uint16_t i = 0; i < n->children; i++) {
+            if (n->keys[i] == byte) return &n->child[i];
+         }
+         return nullptr;
+      }
+      case NODE16: {
+         Node16* n = static_cast<Node16*>(node);
+         for (uint16_t i = 0; i < n->children; i++) {
+            if (n->keys[i] == byte) return &n->child[i];
+         }
+         return nullptr;
+      }
+      case NODE48: {
+         Node48* n = static_cast<Node48*>(node);
+         return n->index[byte] != 0 ? &n->child[n->index[byte] - 1] : nullptr;
+      }
+      default: {
+         Node256* n = static_cast<Node256*>(node);
+         return n->child[byte] != nullptr ? &n->child[byte] : nullptr;
+      }
+   }
+}
+
+// CHILDREN: Visit children in byte order until callback returns false
+template<typename Callback>
+bool AdaptiveRadixTree::forEachChild(const ArtNode* node, Callback&& callback) {
+   switch (node->kind) {
+      case NODE4: {
+         const Node4* n = static_cast<const Node4*>(node);
+         for (uint16_t i = 0; i < n->children; i++) {
+            if (!callback(n->keys[i], n->child[i])) return false;
+         }
+         return true;
+      }
+      case NODE16: {
+         const Node16* n = static_cast<const Node16*>(node);
+         for (uint16_t i = 0; i < n->children; i++) {
+            if (!callback(n->keys[i], n->child[i])) return false;
+         }
+         return true;
+      }
+      case NODE48: {
+         const Node48* n = static_cast<const Node48*>(node);
+         for (unsigned byte = 0; byte < 256; byte++) {
+            if (n->index[byte] != 0 &&
+                !callback(static_cast<unsigned char>(byte), n->child[n->index[byte] - 1])) {
+               return false;
+            }
+         }
+         return true;
+      }
+      default: {
+         const Node256* n = static_cast<const Node256*>(node);
+         for (unsigned byte = 0; byte < 256; byte++) {
+            if (n->child[byte] != nullptr &&
+                !callback(static_cast<unsigned char>(byte), n->child[byte])) {
+               return false;
+            }
+         }
+         return true;
+      }
+   }
+}
+
+// CHILDREN: Add an edge, growing *slot to the next node size when it is full
+inline void AdaptiveRadixTree::addChild(ArtNode** slot, unsigned char byte, ArtNode* child) {
+   ArtNode* node = *slot;
+
+   switch (node->kind) {
+      case NODE4: {
+         Node4* n = static_cast<Node4*>(node);
+         if (n->children < 4) {
+            uint16_t i = n->children;
+            for (; i > 0 && n->keys[i - 1] > byte; i--) {
+               n->keys[i] = n->keys[i - 1];
+               n->child[i] = n->child[i - 1];
+            }
+            n->keys[i] = byte;
+            n->child[i] = child;
+            n->children++;
+            return;
+         }
+
+         Node16* grown = new Node16();
+         std::memcpy(grown->keys, n->keys, sizeof(n->keys));
+         std::memcpy(grown->child, n->child, sizeof(n->child));
+         moveHeader(grown, n);
+         delete n;
+         *slot = grown;
+         break;
+      }
+      case NODE16: {
+         Node16* n = static_cast<Node16*>(node);
+         if (n->children < 16) {
+            uint16_t i = n->children;
+            for (; i > 0 && n->keys[i - 1] > byte; i--) {
+               n->keys[i] = n->keys[i - 1];
+               n->child[i] = n->child[i - 1];
+            }
+            n->keys[i] = byte;
+            n->child[i] = child;
+            n->children++;
+            return;
+         }
+
+         Node48* grown = new Node48();
+         for (uint16_t i = 0; i < 16; i++) {
+            grown->index[n->keys[i]] = static_cast<unsigned char>(i + 1);
+            grown->child[i] = n->child[i];
+         }
+         moveHeader(grown, n);
+         delete n;
+         *slot = grown;
+         break;
+      }
+      case NODE48: {
+         Node48* n = static_cast<Node48*>(node);
+         if (n->children < 48) {
+            unsigned char empty = 0;
+            while (n->child[empty] != nullptr) empty++;
+            n->child[empty] = child;
+            n->index[byte] = static_cast<unsigned char>(empty + 1);
+            n->children++;
+            return;
+         }
+
+         Node256* grown = new Node256();
+         for (unsigned b = 0; b < 256; b++) {
+            if (n->index[b] != 0) grown->child[b] = n->child[n->index[b] - 1];
+         }
+         moveHeader(grown, n);
+         delete n;
+         *slot = grown;
+         break;
+      }
+      default: {
+         Node256* n = static_cast<Node256*>(node);
+         n->child[byte] = child;
+         n->children++;
+         return;
+      }
+   }
+
+   // The grown node has room now
+   addChild(slot, byte, child);
+}
+
+// CHILDREN: Drop an edge (node sizes never shrink; empty subtrees are freed by the caller)
+inline void AdaptiveRadixTree::removeChild(ArtNode* node, unsigned char byte) {
+   switch (node->kind) {
+      case NODE4:
+      case NODE16: {
+         unsigned char* keys = node->kind == NODE4 ? static_cast<Node4*>(node)->keys
+                                                   : static_cast<Node16*>(node)->keys;
+         ArtNode** child = node->kind == NODE4 ? static_cast<Node4*>(node)->child
+                                               : static_cast<Node16*>(node)->child;
+         uint16_t i = 0;
+         while (keys[i] != byte) i++;
+         for (; i + 1 < node->children; i++) {
+            keys[i] = keys[i + 1];
+            child[i] = child[i + 1];
+         }
+         break;
+      }
+      case NODE48: {
+         Node48* n = static_cast<Node48*>(node);
+         n->child[n->index[byte] - 1] = nullptr;
+         n->index[byte] = 0;
+         break;
+      }
+      default:
+         static_cast<Node256*>(node)->child[byte] = nullptr;
+         break;
+   }
+   node->children--;
+}
+
+// PATH COMPRESSION: Fold a node with no key of its own and a single child into that child
+inline void AdaptiveRadixTree::compress(ArtNode** slot) {
+   ArtNode* node = *slot;
+   if (node == root || node->terminal != 0 || node->children != 1) return;
+
+   forEachChild(node, [&](unsigned char byte, const ArtNode* only) {
+      ArtNode* child = const_cast<ArtNode*>(only);
+      child->prefix.insert(0, 1, static_cast<char>(byte));
+      child->prefix.insert(0, node->prefix);
+      *slot = child;
+      return false;
+   });
+   freeNode(node);
+}
+
+// UTILITY: Hand prefix and counts over to a grown node
+inline void AdaptiveRadixTree::moveHeader(ArtNode* to, ArtNode* from) {
+   to->children = from->children;
+   to->prefix = std::move(from->prefix);
+   to->terminal = from->terminal;
+   to->total = from->total;
+}
+
+// MEMORY: Delete through the concrete node type
+inline void AdaptiveRadixTree::freeNode(ArtNode* node) {
+   switch (node->kind) {
+      case NODE4: delete static_cast<Node4*>(node); break;
+      case NODE16: delete static_cast<Node16*>(node); break;
+      case NODE48: delete static_cast<Node48*>(node); break;
+      default: delete static_cast<Node256*>(node); break;
+   }
+}
+
+inline void AdaptiveRadixTree::destroy(ArtNode* node) {
+   forEachChild(node, [](unsigned char, const ArtNode* child) {
+      destroy(const_cast<ArtNode*>(child));
+      return true;
+   });
+   freeNode(node);
+}
+
+// MEMORY: Node structs plus prefix heap, counted like RedBlackTree::memoryUsage() counts keys
+inline size_t AdaptiveRadixTree::nodeBytes(const ArtNode* node) {
+   size_t bytes = 0;
+   switch (node->kind) {
+      case NODE4: bytes = sizeof(Node4); break;
+      case NODE16: bytes = sizeof(Node16); break;
+      case NODE48: bytes = sizeof(Node48); break;
+      default: bytes = sizeof(Node256); break;
+   }
+   bytes += KeyHeapSize<std::string>::bytes(node->prefix);
+
+   forEachChild(node, [&bytes](unsigned char, const ArtNode* child) {
+      bytes += nodeBytes(child);
+      return true;
+   });
+   return bytes;
+}
+
+
+#endif // ADAPTIVE_RADIX_TREE_HH
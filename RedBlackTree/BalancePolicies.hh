@@ -0,0 +1,338 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef BALANCE_POLICIES_HH
+#define BALANCE_POLICIES_HH
+
+#include <cstddef>
+
+// A balancing policy plugs into RedBlackTree<T, Compare, Balance> and provides:
+//   NodeBase                       - per-node balance data (nodes derive from it)
+//   initSentinel(nil)              - balance data of the shared NIL leaf
+//   rotated(lower, upper)          - called after every rotation (upper is the new subtree root)
+//   insertFixup(tree, z)           - restore balance after z was linked in as a leaf
+//   deleteFixup(tree, x, removed)  - restore balance after unlinking; x took the removed spot
+//                                    (x->parent is valid even if x is NIL), removed is the
+//                                    balance data the unlinked position had
+// Policies reach the tree's internals only through TreeAccess, so a policy can wrap another one.
+
+// Gate through which policies (and containers built on the tree) restructure it
+struct TreeAccess {
+   template<typename Tree>
+   static auto root(const Tree& tree) { return tree.root; }
+
+   template<typename Tree>
+   static auto nil(const Tree& tree) { return tree.NIL; }
+
+   template<typename Tree, typename NodeT>
+   static void rotateLeft(Tree& tree, NodeT* x) { tree.rotateLeft(x); }
+
+   template<typename Tree, typename NodeT>
+   static void rotateRight(Tree& tree, NodeT* x) { tree.rotateRight(x); }
+};
+
+// Color enumeration for nodes
+enum class Color {
+   RED,
+   BLACK
+};
+
+// Red-Black: cheap fixups (at most 2 rotations per insert, 3 per delete), height <= 2 log(n+1)
+struct RedBlackBalance {
+   struct NodeBase {
+      Color color = Color::RED;
+   };
+
+   template<typename NodeT>
+   static void initSentinel(NodeT* nil) { nil->color = Color::BLACK; }  // NIL is always black
+
+   template<typename NodeT>
+   static void rotated(NodeT*, NodeT*) {}
+
+   template<typename Tree, typename NodeT>
+   static void insertFixup(Tree& tree, NodeT* z);
+
+   template<typename Tree, typename NodeT>
+   static void deleteFixup(Tree& tree, NodeT* x, const NodeBase& removed);
+};
+
+// AVL: strict height balance (height <= 1.44 log n), best for read-heavy workloads
+struct AvlBalance {
+   struct NodeBase {
+      int height = 1;
+   };
+
+   template<typename NodeT>
+   static void initSentinel(NodeT* nil) { nil->height = 0; }
+
+   template<typename NodeT>
+   static void rotated(NodeT* lower, NodeT* upper) {
+      update(lower);
+      update(upper);
+   }
+
+   template<typename Tree, typename NodeT>
+   static void insertFixup(Tree& tree, NodeT* z) { rebalance(tree, z->parent); }
+
+   template<typename Tree, typename NodeT>
+   static void deleteFixup(Tree& tree, NodeT* x, const NodeBase&) { rebalance(tree, x->parent); }
+
+private:
+   template<typename NodeT>
+   static void update(NodeT* node) {
+      const int left = node->left->height;
+      const int right = node->right->height;
+      node->height = 1 + (left > right ? left : right);
+   }
+
+   template<typename Tree, typename NodeT>
+   static void rebalance(Tree& tree, NodeT* node);
+};
+
+// Weight-balanced (BB[alpha], delta = 3, gamma = 2): keeps subtree sizes, so every node
+// also knows its rank; rebalances by size instead of height
+struct WeightBalance {
+   struct NodeBase {
+      size_t size = 1;
+   };
+
+   template<typename NodeT>
+   static void initSentinel(NodeT* nil) { nil->size = 0; }
+
+   template<typename NodeT>
+   static void rotated(NodeT* lower, NodeT* upper) {
+      update(lower);
+      update(upper);
+   }
+
+   template<typename Tree, typename NodeT>
+   static void insertFixup(Tree& tree, NodeT* z) { rebalance(tree, z->parent); }
+
+   template<typename Tree, typename NodeT>
+   static void deleteFixup(Tree& tree, NodeT* x, const NodeBase&) { rebalance(tree, x->parent); }
+
+private:
+   static constexpr size_t DELTA = 3;  // Max weight ratio between siblings
+   static constexpr size_t GAMMA = 2;  // Single vs double rotation threshold
+
+   template<typename NodeT>
+   static void update(NodeT* node) { node->size = 1 + node->left->size + node->right->size; }
+
+   template<typename Tree, typename NodeT>
+   static void rebalance(Tree& tree, NodeT* node);
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// RED-BLACK INSERT FIXUP: Restore Red-Black properties after insertion
+template<typename Tree, typename NodeT>
+void RedBlackBalance::insertFixup(Tree& tree, NodeT* z) {
+   // Continue while parent is red (violation of property 4)
+   while (z->parent != nullptr && z->parent->color == Color::RED) {
+
+      // Parent is LEFT child of grandparent
+      if (z->parent == z->parent->parent->left) {
+         NodeT* uncle = z->parent->parent->right;  // Uncle is right child
+
+         // CASE 1: Uncle is RED
+         if (uncle->color == Color::RED) {
+            z->parent->color = Color::BLACK;         // Recolor parent
+            uncle->color = Color::BLACK;              // Recolor uncle
+            z->parent->parent->color = Color::RED;    // Recolor grandparent
+            z = z->parent->parent;                    // Move up to grandparent
+         }
+         // Uncle is BLACK
+         else {
+            // CASE 2: z is RIGHT child (convert to Case 3)
+            if (z == z->parent->right) {
+               z = z->parent;
+               TreeAccess::rotateLeft(tree, z);  // Transform to Case 3
+            }
+
+            // CASE 3: z is LEFT child
+            z->parent->color = Color::BLACK;          // Recolor parent
+            z->parent->parent->color = Color::RED;    // Recolor grandparent
+            TreeAccess::rotateRight(tree, z->parent->parent);  // Rotate right
+         }
+      }
+      // Parent is RIGHT child of grandparent (symmetric)
+      else {
+         NodeT* uncle = z->parent->parent->left;  // Uncle is left child
+
+         // CASE 1: Uncle is RED
+         if (uncle->color == Color::RED) {
+            z->parent->color = Color::BLACK;
+            uncle->color = Color::BLACK;
+            z->parent->parent->color = Color::RED;
+            z = z->parent->parent;
+         }
+         // Uncle is BLACK
+         else {
+            // CASE 2: z is LEFT child (convert to Case 3)
+            if (z == z->parent->left) {
+               z = z->parent;
+               TreeAccess::rotateRight(tree, z);  // Transform to Case 3
+            }
+
+            // CASE 3: z is RIGHT child
+            z->parent->color = Color::BLACK;
+            z->parent->parent->color = Color::RED;
+            TreeAccess::rotateLeft(tree, z->parent->parent);
+         }
+      }
+   }
+
+   // Ensure root is always black (property 2)
+   TreeAccess::root(tree)->color = Color::BLACK;
+}
+
+// RED-BLACK DELETE FIXUP: Restore Red-Black properties after deletion
+template<typename Tree, typename NodeT>
+void RedBlackBalance::deleteFixup(Tree& tree, NodeT* x, const NodeBase& removed) {
+   // Only removing a BLACK node breaks the black-height (property 5)
+   if (removed.color != Color::BLACK) return;
+
+   // Continue while x is not root and x is black (double black)
+   while (x != TreeAccess::root(tree) && x->color == Color::BLACK) {
+
+      // x is LEFT child
+      if (x == x->parent->left) {
+         NodeT* w = x->parent->right;  // Sibling
+
+         // CASE 1: Sibling is RED
+         if (w->color == Color::RED) {
+            w->color = Color::BLACK;           // Recolor sibling
+            x->parent->color = Color::RED;     // Recolor parent
+            TreeAccess::rotateLeft(tree, x->parent);  // Rotate left
+            w = x->parent->right;              // Update sibling
+         }
+
+         // CASE 2: Sibling BLACK + both children BLACK
+         if (w->left->color == Color::BLACK && w->right->color == Color::BLACK) {
+            w->color = Color::RED;  // Recolor sibling
+            x = x->parent;          // Move problem up
+         }
+         else {
+            // CASE 3: Sibling BLACK + left RED, right BLACK
+            if (w->right->color == Color::BLACK) {
+               w->left->color = Color::BLACK;   // Recolor left child
+               w->color = Color::RED;           // Recolor sibling
+               TreeAccess::rotateRight(tree, w);  // Rotate right
+               w = x->parent->right;            // Update sibling
+            }
+
+            // CASE 4: Sibling BLACK + right RED
+            w->color = x->parent->color;        // Copy parent's color
+            x->parent->color = Color::BLACK;    // Recolor parent
+            w->right->color = Color::BLACK;     // Recolor right child
+            TreeAccess::rotateLeft(tree, x->parent);  // Rotate left
+            x = TreeAccess::root(tree);               // Terminate loop
+         }
+      }
+      // x is RIGHT child (symmetric cases)
+      else {
+         NodeT* w = x->parent->left;  // Sibling
+
+         // CASE 1: Sibling is RED
+         if (w->color == Color::RED) {
+            w->color = Color::BLACK;
+            x->parent->color = Color::RED;
+            TreeAccess::rotateRight(tree, x->parent);
+            w = x->parent->left;
+         }
+
+         // CASE 2: Sibling BLACK + both children BLACK
+         if (w->right->color == Color::BLACK && w->left->color == Color::BLACK) {
+            w->color = Color::RED;
+            x = x->parent;
+         }
+         else {
+            // CASE 3: Sibling BLACK + right RED, left BLACK
+            if (w->left->color == Color::BLACK) {
+               w->right->color = Color::BLACK;
+               w->color = Color::RED;
+               TreeAccess::rotateLeft(tree, w);
+               w = x->parent->left;
+            }
+
+            // CASE 4: Sibling BLACK + left RED
+            w->color = x->parent->color;
+            x->parent->color = Color::BLACK;
+            w->left->color = Color::BLACK;
+            TreeAccess::rotateRight(tree, x->parent);
+            x = TreeAccess::root(tree);
+         }
+      }
+   }
+
+   // Ensure x is black
+   x->color = Color::BLACK;
+}
+
+// AVL REBALANCE: Walk up from node, fixing heights and rotating where |balance| > 1
+template<typename Tree, typename NodeT>
+void AvlBalance::rebalance(Tree& tree, NodeT* node) {
+   while (node != nullptr) {
+      const int oldHeight = node->height;
+      update(node);
+      const int balance = node->left->height - node->right->height;
+
+      // Left-heavy: Left-Right case becomes Left-Left with one extra rotation
+      if (balance > 1) {
+         if (node->left->left->height < node->left->right->height) {
+            TreeAccess::rotateLeft(tree, node->left);
+         }
+         TreeAccess::rotateRight(tree, node);
+         node = node->parent;  // New root of this subtree
+      }
+      // Right-heavy (symmetric)
+      else if (balance < -1) {
+         if (node->right->right->height < node->right->left->height) {
+            TreeAccess::rotateRight(tree, node->right);
+         }
+         TreeAccess::rotateLeft(tree, node);
+         node = node->parent;
+      }
+
+      // Subtree height unchanged: nothing above can be affected
+      if (node->height == oldHeight) return;
+      node = node->parent;
+   }
+}
+
+// WEIGHT REBALANCE: Walk up to the root, refreshing sizes and restoring the weight ratio
+template<typename Tree, typename NodeT>
+void WeightBalance::rebalance(Tree& tree, NodeT* node) {
+   while (node != nullptr) {
+      update(node);
+      const size_t leftWeight = node->left->size + 1;
+      const size_t rightWeight = node->right->size + 1;
+
+      // Right too heavy: double rotation when its inner grandchild outweighs the outer one
+      if (rightWeight > DELTA * leftWeight) {
+         NodeT* right = node->right;
+         if (right->left->size + 1 >= GAMMA * (right->right->size + 1)) {
+            TreeAccess::rotateRight(tree, right);
+         }
+         TreeAccess::rotateLeft(tree, node);
+         node = node->parent;  // New root of this subtree
+      }
+      // Left too heavy (symmetric)
+      else if (leftWeight > DELTA * rightWeight) {
+         NodeT* left = node->left;
+         if (left->right->size + 1 >= GAMMA * (left->left->size + 1)) {
+            TreeAccess::rotateLeft(tree, left);
+         }
+         TreeAccess::rotateRight(tree, node);
+         node = node->parent;
+      }
+
+      // Sizes change all the way up, so no early exit
+      node = node->parent;
+   }
+}
+
+
+#endif // BALANCE_POLICIES_HH
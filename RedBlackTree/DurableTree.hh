@@ -0,0 +1,441 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef DURABLE_TREE_HH
+#define DURABLE_TREE_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "RedBlackTree.hh"
+#include "Serialization.hh"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Options for DurableTree
+struct DurabilityOptions {
+   std::string directory = ".";          // Log segments and checkpoint live here
+   std::string name = "tree";            // File prefix: <name>.wal.<generation>, <name>.ckpt
+   size_t groupCommitBytes = 1 << 20;    // Write and sync the log once this much is buffered
+   size_t checkpointInterval = 1 << 20;  // Operations between background checkpoints (0: manual)
+   bool sync = true;                     // fsync log groups and checkpoints (POSIX only)
+};
+
+// UTILITY: Checksummed frame [u32 length][u32 crc][payload] used by logs and checkpoints
+inline void appendFrame(std::string& out, const std::string& payload) {
+   encodeU32(out, static_cast<uint32_t>(payload.size()));
+   encodeU32(out, crc32(payload.data(), payload.size()));
+   out += payload;
+}
+
+// Reads one frame; false on end of file or on a torn / corrupt frame
+inline bool readFrame(std::istream& in, std::string& payload) {
+   uint32_t length = 0;
+   uint32_t checksum = 0;
+   if (!decodeU32(in, length) || !decodeU32(in, checksum) || length > (1u << 30)) return false;
+
+   payload.resize(length);
+   if (!in.read(&payload[0], length)) return false;
+   return crc32(payload.data(), payload.size()) == checksum;
+}
+
+// UTILITY: Flush stdio buffers and, if asked, force the data to disk
+inline bool syncFile(std::FILE* file, bool sync) {
+   if (std::fflush(file) != 0) return false;
+#if defined(__unix__) || defined(__APPLE__)
+   if (sync && fsync(fileno(file)) != 0) return false;
+#endif
+   return true;
+}
+
+// UTILITY: Make a rename inside directory durable (POSIX only)
+inline void syncDirectory(const std::string& directory, bool sync) {
+#if defined(__unix__) || defined(__APPLE__)
+   if (!sync) return;
+   const int descriptor = open(directory.c_str(), O_RDONLY);
+   if (descriptor >= 0) {
+      fsync(descriptor);
+      close(descriptor);
+   }
+#else
+   (void)directory;
+   (void)sync;
+#endif
+}
+
+// Crash-safe RedBlackTree: every insert/remove is appended to a checksummed write-ahead log,
+// written in groups (group commit). A checkpoint snapshots the tree and starts a new log
+// segment; recovery loads the last checkpoint and replays only the segments written after it.
+// An operation is durable once commit() returns true (or its group filled up and was written).
+// The first failed write or sync closes the log for good: isOpen() turns false and every later
+// commit() fails, while operations keep changing only the in-memory tree.
+// Not thread-safe: one thread issues all operations; checkpoints are written in the background.
+template<typename T, typename Compare = std::less<T>, typename Balance = RedBlackBalance>
+class DurableTree {
+private:
+   using Tree = RedBlackTree<T, Compare, Balance>;
+
+   enum Operation : char {
+      INSERT = 1,
+      REMOVE = 2
+   };
+
+   static constexpr uint32_t CHECKPOINT_MAGIC = 0x50434252;  // "RBCP"
+
+   DurabilityOptions options;
+   Tree data;
+   std::FILE* log;
+   uint64_t generation;        // Segment currently appended to
+   std::string group;          // Log frames not yet written
+   size_t sinceCheckpoint;     // Operations logged since the last checkpoint started
+   size_t replayed;            // Operations replayed by the last recovery
+   std::thread checkpointer;
+   std::atomic<bool> checkpointing;
+   std::atomic<bool> checkpointOk;
+
+   std::string segmentPath(uint64_t segment) const;
+   std::string checkpointPath() const;
+
+   void recover();
+   bool loadCheckpoint(uint64_t& base);
+   bool replaySegment(const std::string& path, uint64_t& validBytes);
+   void append(Operation op, const T& value);
+   bool startCheckpoint();
+   void writeCheckpoint(std::unique_ptr<Tree> snapshot, uint64_t base);
+
+public:
+   explicit DurableTree(const DurabilityOptions& options = DurabilityOptions());
+   ~DurableTree();
+
+   DurableTree(const DurableTree&) = delete;
+   DurableTree& operator=(const DurableTree&) = delete;
+
+   // Core operations (applied, then logged)
+   void insert(const T& value);
+   bool remove(const T& value);
+   bool contains(const T& value) const { return data.contains(value); }
+
+   // Read-only access to the in-memory tree
+   const Tree& tree() const { return data; }
+   size_t size() const { return data.size(); }
+
+   // Durability
+   bool commit();      // Write and sync the pending group
+   bool checkpoint();  // Snapshot now and wait for it; older log segments are then deleted
+   bool isOpen() const { return log != nullptr; }
+   size_t recoveredOperations() const { return replayed; }
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// CONSTRUCTOR & DESTRUCTOR
+template<typename T, typename Compare, typename Balance>
+DurableTree<T, Compare, Balance>::DurableTree(const DurabilityOptions& options)
+   : options(options), log(nullptr), generation(1), sinceCheckpoint(0), replayed(0),
+     checkpointing(false), checkpointOk(true) {
+   recover();
+}
+
+template<typename T, typename Compare, typename Balance>
+DurableTree<T, Compare, Balance>::~DurableTree() {
+   if (log != nullptr) {
+      commit();
+   }
+   if (checkpointer.joinable()) {
+      checkpointer.join();
+   }
+   if (log != nullptr) {
+      std::fclose(log);
+   }
+}
+
+// PATHS
+template<typename T, typename Compare, typename Balance>
+std::string DurableTree<T, Compare, Balance>::segmentPath(uint64_t segment) const {
+   return options.directory + "/" + options.name + ".wal." + std::to_string(segment);
+}
+
+template<typename T, typename Compare, typename Balance>
+std::string DurableTree<T, Compare, Balance>::checkpointPath() const {
+   return options.directory + "/" + options.name + ".ckpt";
+}
+
+// RECOVERY: Checkpoint first, then every segment from its generation on, in order
+template<typename T, typename Compare, typename Balance>
+void DurableTree<T, Compare, Balance>::recover() {
+   namespace fs = std::filesystem;
+   std::error_code error;
+
+   // A checkpoint with base G holds every operation from segments older than G, and those
+   // segments are gone. Only when no checkpoint was ever written is every segment replayed;
+   // a damaged one cannot be rebuilt from the log, so the tree stays closed (isOpen() false)
+   // and no file is touched.
+   uint64_t base = 0;
+   if (fs::exists(checkpointPath(), error)) {
+      if (!loadCheckpoint(base)) {
+         data.clear();
+         return;
+      }
+   }
+
+   // Collect <name>.wal.<generation> files
+   const std::string prefix = options.name + ".wal.";
+   std::vector<uint64_t> segments;
+   for (const fs::directory_entry& entry : fs::directory_iterator(options.directory, error)) {
+      const std::string file = entry.path().filename().string();
+      if (file.compare(0, prefix.size(), prefix) == 0 && file.size() > prefix.size() &&
+          file.find_first_not_of("0123456789", prefix.size()) == std::string::npos) {
+         segments.push_back(std::stoull(file.substr(prefix.size())));
+      }
+   }
+   std::sort(segments.begin(), segments.end());
+
+   generation = std::max<uint64_t>(base, 1);
+   for (uint64_t segment : segments) {
+      // Already covered by the checkpoint
+      if (segment < base) {
+         fs::remove(segmentPath(segment), error);
+         continue;
+      }
+
+      generation = segment;
+      uint64_t validBytes = 0;
+      if (!replaySegment(segmentPath(segment), validBytes)) {
+         // Older segments were synced before a newer one was started, so only the newest can
+         // end in a torn group from a crash. A bad frame anywhere else is corruption: keep every
+         // file for inspection and leave the tree closed, as for a damaged checkpoint.
+         if (segment != segments.back()) {
+            data.clear();
+            return;
+         }
+
+         // Torn group: cut the segment back to its last complete frame
+         fs::resize_file(segmentPath(segment), validBytes, error);
+      }
+   }
+
+   log = std::fopen(segmentPath(generation).c_str(), "ab");
+}
+
+// RECOVERY: Header frame [magic][base][count], then frames of encoded keys in sorted order
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::loadCheckpoint(uint64_t& base) {
+   std::ifstream in(checkpointPath(), std::ios::binary);
+   if (!in.is_open()) return false;
+
+   std::string payload;
+   if (!readFrame(in, payload)) return false;
+
+   std::istringstream header(payload);
+   uint32_t magic = 0;
+   uint64_t count = 0;
+   if (!decodeU32(header, magic) || magic != CHECKPOINT_MAGIC ||
+       !decodeU64(header, base) || !decodeU64(header, count)) {
+      return false;
+   }
+
+   T value;
+   uint64_t loaded = 0;
+   while (loaded < count) {
+      if (!readFrame(in, payload)) return false;
+
+      std::istringstream keys(payload);
+      while (loaded < count && keys.peek() != EOF) {
+         if (!KeyCodec<T>::decode(keys, value)) return false;
+         data.insert(value);
+         loaded++;
+      }
+   }
+   return true;
+}
+
+// RECOVERY: Apply every intact frame; false (with the intact prefix length) on a bad one
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::replaySegment(const std::string& path, uint64_t& validBytes) {
+   std::ifstream in(path, std::ios::binary);
+   std::string payload;
+   T value;
+
+   validBytes = 0;
+   while (in.peek() != EOF) {
+      if (!readFrame(in, payload) || payload.empty()) return false;
+
+      std::istringstream key(payload.substr(1));
+      if (!KeyCodec<T>::decode(key, value)) return false;
+
+      if (payload[0] == INSERT) {
+         data.insert(value);
+      } else {
+         data.remove(value);
+      }
+
+      replayed++;
+      validBytes = static_cast<uint64_t>(in.tellg());
+   }
+   return true;
+}
+
+// WRITE: Apply, then log. Logging may seal the segment and snapshot the tree, so the
+// snapshot must already contain the operation. Removals that change nothing are not logged.
+template<typename T, typename Compare, typename Balance>
+void DurableTree<T, Compare, Balance>::insert(const T& value) {
+   data.insert(value);
+   append(INSERT, value);
+}
+
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::remove(const T& value) {
+   if (!data.remove(value)) return false;
+
+   append(REMOVE, value);
+   return true;
+}
+
+// WRITE: Frames accumulate in memory and hit the disk one group at a time
+template<typename T, typename Compare, typename Balance>
+void DurableTree<T, Compare, Balance>::append(Operation op, const T& value) {
+   if (log == nullptr) return;  // Closed after a write error: nothing is logged any more
+
+   std::string payload(1, op);
+   KeyCodec<T>::encode(payload, value);
+   appendFrame(group, payload);
+
+   if (group.size() >= options.groupCommitBytes && !commit()) return;
+
+   sinceCheckpoint++;
+   if (options.checkpointInterval > 0 && sinceCheckpoint >= options.checkpointInterval &&
+       !checkpointing) {
+      startCheckpoint();
+   }
+}
+
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::commit() {
+   if (log == nullptr) return false;
+   if (group.empty()) return true;
+
+   const bool written = std::fwrite(group.data(), 1, group.size(), log) == group.size();
+   if (written && syncFile(log, options.sync)) {
+      group.clear();
+      return true;
+   }
+
+   // A failed write or sync leaves the segment's tail unknown: stop logging for good, so
+   // every later commit() reports the loss (recovery cuts off a torn group)
+   std::fclose(log);
+   log = nullptr;
+   group.clear();
+   return false;
+}
+
+// CHECKPOINT: Synchronous version of the background checkpoint
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::checkpoint() {
+   if (checkpointer.joinable()) {
+      checkpointer.join();
+   }
+   if (!startCheckpoint()) return false;
+
+   checkpointer.join();
+   return checkpointOk;
+}
+
+// CHECKPOINT: Seal the current segment, clone the tree (O(n), no comparisons) and write the
+// clone on a background thread while new operations go to the next segment
+template<typename T, typename Compare, typename Balance>
+bool DurableTree<T, Compare, Balance>::startCheckpoint() {
+   if (!commit()) return false;
+   if (checkpointer.joinable()) {
+      checkpointer.join();
+   }
+
+   std::FILE* next = std::fopen(segmentPath(generation + 1).c_str(), "ab");
+   if (next == nullptr) return false;
+
+   std::fclose(log);
+   log = next;
+   generation++;
+   sinceCheckpoint = 0;
+
+   checkpointing = true;
+   std::unique_ptr<Tree> snapshot(new Tree(data));
+   checkpointer = std::thread(&DurableTree::writeCheckpoint, this, std::move(snapshot), generation);
+   return true;
+}
+
+// CHECKPOINT: Write to a temporary file, sync, rename over the old checkpoint, then drop the
+// segments it covers. A crash at any point leaves either the old or the new checkpoint valid.
+template<typename T, typename Compare, typename Balance>
+void DurableTree<T, Compare, Balance>::writeCheckpoint(std::unique_ptr<Tree> snapshot, uint64_t base) {
+   namespace fs = std::filesystem;
+   std::error_code error;
+
+   const std::string temporary = checkpointPath() + ".tmp";
+   std::FILE* file = std::fopen(temporary.c_str(), "wb");
+   bool ok = file != nullptr;
+
+   if (ok) {
+      std::string header;
+      encodeU32(header, CHECKPOINT_MAGIC);
+      encodeU64(header, base);
+      encodeU64(header, snapshot->size());
+
+      std::string frames;
+      appendFrame(frames, header);
+
+      // Keys are packed into ~1 MB frames
+      std::string keys;
+      snapshot->inorder([&](const T& value) {
+         KeyCodec<T>::encode(keys, value);
+         if (keys.size() >= (1 << 20)) {
+            appendFrame(frames, keys);
+            keys.clear();
+            ok = ok && std::fwrite(frames.data(), 1, frames.size(), file) == frames.size();
+            frames.clear();
+         }
+      });
+      if (!keys.empty()) {
+         appendFrame(frames, keys);
+      }
+
+      ok = ok && std::fwrite(frames.data(), 1, frames.size(), file) == frames.size();
+      ok = syncFile(file, options.sync) && ok;
+      ok = (std::fclose(file) == 0) && ok;
+   }
+
+   snapshot.reset();
+
+   if (ok) {
+      fs::rename(temporary, checkpointPath(), error);
+      ok = !error;
+   }
+
+   if (ok) {
+      syncDirectory(options.directory, options.sync);
+      for (uint64_t segment = base - 1; segment > 0; segment--) {
+         if (!fs::remove(segmentPath(segment), error)) break;  // Older ones are already gone
+      }
+   } else {
+      fs::remove(temporary, error);
+   }
+
+   checkpointOk = ok;
+   checkpointing = false;
+}
+
+
+#endif // DURABLE_TREE_HH
@@ -0,0 +1,175 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef INTERVAL_TREE_HH
+#define INTERVAL_TREE_HH
+
+#include <limits>
+#include <vector>
+#include "RedBlackTree.hh"
+
+// Closed interval [low, high]
+template<typename T>
+struct Interval {
+   T low;
+   T high;
+
+   bool operator==(const Interval& other) const {
+      return low == other.low && high == other.high;
+   }
+};
+
+// Intervals are ordered by low endpoint, then by high endpoint
+template<typename T>
+struct IntervalLess {
+   bool operator()(const Interval<T>& a, const Interval<T>& b) const {
+      if (a.low < b.low) return true;
+      if (b.low < a.low) return false;
+      return a.high < b.high;
+   }
+};
+
+// Augmenting policy: wraps a balancing policy and keeps, in every node, the largest high
+// endpoint of its subtree. Rotations recompute it locally; inserts and deletes refresh the
+// path to the root before the wrapped fixup runs.
+// NIL holds numeric_limits<T>::lowest() (T() for types without limits, e.g. "" for strings).
+template<typename T, typename Base = RedBlackBalance>
+struct IntervalBalance {
+   struct NodeBase : Base::NodeBase {
+      T maxHigh;
+   };
+
+   template<typename NodeT>
+   static void initSentinel(NodeT* nil) {
+      Base::initSentinel(nil);
+      nil->maxHigh = std::numeric_limits<T>::lowest();
+   }
+
+   template<typename NodeT>
+   static void rotated(NodeT* lower, NodeT* upper) {
+      Base::rotated(lower, upper);
+      update(lower);
+      update(upper);
+   }
+
+   template<typename Tree, typename NodeT>
+   static void insertFixup(Tree& tree, NodeT* z);
+
+   template<typename Tree, typename NodeT>
+   static void deleteFixup(Tree& tree, NodeT* x, const NodeBase& removed);
+
+private:
+   template<typename NodeT>
+   static void update(NodeT* node) {
+      node->maxHigh = node->data.high;
+      if (node->maxHigh < node->left->maxHigh) node->maxHigh = node->left->maxHigh;
+      if (node->maxHigh < node->right->maxHigh) node->maxHigh = node->right->maxHigh;
+   }
+};
+
+// Template class for Interval Tree (stabbing and overlap queries on a balanced tree)
+template<typename T, typename Balance = RedBlackBalance>
+class IntervalTree {
+private:
+   using Tree = RedBlackTree<Interval<T>, IntervalLess<T>, IntervalBalance<T, Balance>>;
+   using NodeType = Node<Interval<T>, IntervalBalance<T, Balance>>;
+
+   Tree tree;
+
+   template<typename Visitor>
+   void overlappingHelper(const NodeType* node, const NodeType* nil,
+                          const T& low, const T& high, Visitor& visit) const;
+
+public:
+   // Core operations - O(log n)
+   void insert(const T& low, const T& high) { tree.insert(Interval<T>{low, high}); }
+   bool remove(const T& low, const T& high) { return tree.remove(Interval<T>{low, high}); }
+   bool contains(const T& low, const T& high) const { return tree.contains(Interval<T>{low, high}); }
+
+   // Utility operations
+   bool isEmpty() const { return tree.isEmpty(); }
+   size_t size() const { return tree.size(); }
+   void clear() { tree.clear(); }
+   MemoryUsage memoryUsage() const { return tree.memoryUsage(); }
+
+   // Queries: every stored interval intersecting [low, high] (or containing point), in sorted
+   // order. Subtrees whose max endpoint is below low, or that start after high, are skipped:
+   // each match costs at most one root-to-leaf path, so k matches cost O(min(n, (k+1) log n)).
+   template<typename Visitor>
+   void visitOverlapping(const T& low, const T& high, Visitor&& visit) const;
+
+   std::vector<Interval<T>> overlapping(const T& low, const T& high) const;
+   std::vector<Interval<T>> overlapping(const T& point) const { return overlapping(point, point); }
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// AUGMENTED INSERT: z is a fresh leaf; raise maxHigh on its ancestors, then rebalance
+template<typename T, typename Base>
+template<typename Tree, typename NodeT>
+void IntervalBalance<T, Base>::insertFixup(Tree& tree, NodeT* z) {
+   z->maxHigh = z->data.high;
+
+   // Inserting only raises maxima, so stop at the first ancestor that already covers z
+   NodeT* node = z->parent;
+   while (node != nullptr && node->maxHigh < z->maxHigh) {
+      node->maxHigh = z->maxHigh;
+      node = node->parent;
+   }
+
+   // Rotations done by the wrapped fixup keep maxHigh correct through rotated()
+   Base::insertFixup(tree, z);
+}
+
+// AUGMENTED DELETE: Refresh maxHigh from the unlinked spot up to the root, then rebalance
+template<typename T, typename Base>
+template<typename Tree, typename NodeT>
+void IntervalBalance<T, Base>::deleteFixup(Tree& tree, NodeT* x, const NodeBase& removed) {
+   // The successor that replaced the removed node copied its stale maxHigh, so no early exit
+   for (NodeT* node = x->parent; node != nullptr; node = node->parent) {
+      update(node);
+   }
+
+   Base::deleteFixup(tree, x, removed);
+}
+
+// QUERY: Collect overlapping intervals into a vector
+template<typename T, typename Balance>
+std::vector<Interval<T>> IntervalTree<T, Balance>::overlapping(const T& low, const T& high) const {
+   std::vector<Interval<T>> result;
+   visitOverlapping(low, high, [&result](const Interval<T>& interval) {
+      result.push_back(interval);
+   });
+   return result;
+}
+
+template<typename T, typename Balance>
+template<typename Visitor>
+void IntervalTree<T, Balance>::visitOverlapping(const T& low, const T& high, Visitor&& visit) const {
+   overlappingHelper(TreeAccess::root(tree), TreeAccess::nil(tree), low, high, visit);
+}
+
+// QUERY HELPER: Inorder walk pruned by maxHigh (left side) and by low endpoint (right side)
+template<typename T, typename Balance>
+template<typename Visitor>
+void IntervalTree<T, Balance>::overlappingHelper(const NodeType* node, const NodeType* nil,
+                                                 const T& low, const T& high, Visitor& visit) const {
+   // Nothing in this subtree reaches up to low
+   if (node == nil || node->maxHigh < low) return;
+
+   overlappingHelper(node->left, nil, low, high, visit);
+
+   // This node and its whole right subtree start after high
+   if (high < node->data.low) return;
+
+   if (!(node->data.high < low)) {
+      visit(node->data);
+   }
+
+   overlappingHelper(node->right, nil, low, high, visit);
+}
+
+
+#endif // INTERVAL_TREE_HH
@@ -0,0 +1,729 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef LSM_TREE_HH
+#define LSM_TREE_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "RedBlackTree.hh"
+#include "Serialization.hh"
+
+// Options for LsmTree
+struct LsmOptions {
+   std::string directory = ".";       // Where run files go (files are removed with the tree)
+   size_t memtableBytes = 64 << 20;   // Flush the in-memory tree once it uses this much
+   size_t fenceInterval = 64;         // Records per block; one fence key is kept per block
+   size_t bloomBitsPerKey = 10;       // ~1% false positives at 10; 0 disables Bloom filters
+   size_t compactionTrigger = 8;      // Look for runs to merge once there are this many
+   size_t sizeRatio = 2;              // An older run joins a merge if <= ratio x the newer ones
+   size_t maxRuns = 16;               // Past this many runs, flush() waits for compaction
+};
+
+// Memtable / run record: a key, or a tombstone hiding older copies of it
+template<typename T>
+struct LsmEntry {
+   T key;
+   mutable bool tombstone;  // Not part of the ordering, so it can be flipped in place
+};
+
+// Orders entries by key only, with the tree's three-way comparator
+template<typename T, typename Compare>
+struct LsmEntryOrder {
+   Compare comp;
+   auto operator()(const LsmEntry<T>& a, const LsmEntry<T>& b) const { return comp(a.key, b.key); }
+};
+
+// Bloom filter over key hashes (double hashing, k probes)
+class BloomFilter {
+private:
+   std::vector<uint64_t> bits;
+   size_t bitCount;
+   unsigned probes;
+
+public:
+   BloomFilter() : bitCount(0), probes(0) {}
+
+   BloomFilter(size_t keys, size_t bitsPerKey)
+      : bitCount(keys * bitsPerKey < 64 ? 64 : keys * bitsPerKey),
+        probes(bitsPerKey * 69 / 100 < 1 ? 1 : static_cast<unsigned>(bitsPerKey * 69 / 100)) {
+      bits.assign((bitCount + 63) / 64, 0);
+   }
+
+   void add(size_t hash) {
+      uint64_t h1 = hash;
+      const uint64_t h2 = mix(hash);
+      for (unsigned i = 0; i < probes; i++, h1 += h2) {
+         bits[(h1 % bitCount) / 64] |= uint64_t(1) << ((h1 % bitCount) % 64);
+      }
+   }
+
+   // An empty (disabled) filter never rules anything out
+   bool mayContain(size_t hash) const {
+      if (bitCount == 0) return true;
+
+      uint64_t h1 = hash;
+      const uint64_t h2 = mix(hash);
+      for (unsigned i = 0; i < probes; i++, h1 += h2) {
+         if (!(bits[(h1 % bitCount) / 64] & (uint64_t(1) << ((h1 % bitCount) % 64)))) return false;
+      }
+      return true;
+   }
+
+   size_t memoryBytes() const { return bits.size() * sizeof(uint64_t); }
+
+private:
+   // Second, independent-looking hash (splitmix64 finalizer), forced odd
+   static uint64_t mix(uint64_t x) {
+      x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return x | 1;
+   }
+};
+
+// Point lookup result in one run
+enum class RunLookup {
+   ABSENT,   // Key not in this run: keep looking in older runs
+   LIVE,     // Key present
+   DELETED,  // Tombstone: key removed, older runs must not be consulted
+   FAILED    // Run file could not be opened or read: the answer is unknown
+};
+
+// Immutable sorted run file: records [u8 tombstone][key], ascending and unique.
+// Fence keys (first key of every block) and the Bloom filter stay in memory.
+template<typename T, typename Compare>
+class SortedRun {
+private:
+   std::string filePath;
+   Compare comp;
+   size_t count;
+   size_t fenceInterval;
+   std::vector<T> fenceKeys;
+   std::vector<uint64_t> fenceOffsets;
+   BloomFilter bloom;
+
+   // Point lookups share one stream; cursors open their own
+   mutable std::mutex streamMutex;
+   mutable std::ifstream stream;
+
+   template<typename, typename> friend class RunWriter;
+   template<typename, typename> friend class RunCursor;
+
+public:
+   SortedRun(const std::string& path, const Compare& comp, size_t fenceInterval)
+      : filePath(path), comp(comp), count(0), fenceInterval(fenceInterval) {}
+
+   ~SortedRun() {
+      stream.close();
+      std::remove(filePath.c_str());
+   }
+
+   SortedRun(const SortedRun&) = delete;
+   SortedRun& operator=(const SortedRun&) = delete;
+
+   size_t size() const { return count; }
+   size_t block(const T& key) const;
+   RunLookup find(const T& key, size_t hash) const;
+   size_t memoryBytes() const;
+};
+
+// Reads a run sequentially from a given key on
+template<typename T, typename Compare>
+class RunCursor {
+private:
+   const SortedRun<T, Compare>* run;
+   std::ifstream in;
+   size_t remaining;
+   T current;
+   bool deleted;
+   bool ok;
+   bool error;
+
+public:
+   explicit RunCursor(const SortedRun<T, Compare>& run)
+      : run(&run), in(run.filePath, std::ios::binary), remaining(run.count), current(),
+        deleted(false), ok(false), error(false) {
+      next();
+   }
+
+   void seek(const T& low);
+   void next();
+
+   bool valid() const { return ok; }
+   bool failed() const { return error; }  // Stopped on an I/O error, not at the end of the run
+   const T& key() const { return current; }
+   bool tombstone() const { return deleted; }
+};
+
+// Writes a new run, building its fence index and Bloom filter on the way
+template<typename T, typename Compare>
+class RunWriter {
+private:
+   std::unique_ptr<SortedRun<T, Compare>> run;
+   std::ofstream out;
+   std::string buffer;
+   uint64_t offset;
+
+public:
+   RunWriter(const std::string& path, const Compare& comp, const LsmOptions& options,
+             size_t expectedKeys);
+
+   void append(const T& key, bool tombstone);
+   std::shared_ptr<SortedRun<T, Compare>> finish();  // nullptr on I/O failure
+};
+
+// Log-structured merge tree: a RedBlackTree memtable absorbs writes and is flushed as an
+// immutable sorted run once it exceeds options.memtableBytes. Lookups and scans merge the
+// memtable with every run (newest wins, tombstones hide older keys). Once there are
+// options.compactionTrigger runs, a background thread merges neighbouring runs of similar size
+// (size-tiered), so each key is rewritten O(log n) times rather than on every compaction. If
+// compaction falls behind, flush() merges in the foreground until at most options.maxRuns remain.
+// Keys are a set (inserting twice keeps one copy). Compare must be three-way.
+// Writes and reads come from one thread; only compaction runs concurrently.
+template<typename T, typename Compare = ThreeWayCompare<T>>
+class LsmTree {
+private:
+   static_assert(!std::is_same<decltype(std::declval<const Compare&>()(std::declval<const T&>(),
+                                                                        std::declval<const T&>())),
+                               bool>::value,
+                 "LsmTree needs a three-way comparator, e.g. ThreeWayCompare<T>");
+
+   using Memtable = RedBlackTree<LsmEntry<T>, LsmEntryOrder<T, Compare>>;
+   using Run = SortedRun<T, Compare>;
+   using RunList = std::vector<std::shared_ptr<Run>>;
+
+   LsmOptions options;
+   Compare comp;
+   Memtable memtable;
+   size_t memtableUsage;  // Node and key heap bytes of the memtable
+   size_t flushAt;        // Usage that triggers the next automatic flush
+   bool flushError;       // The last flush failed
+   mutable std::atomic<bool> readError;  // A run could not be read (sticky)
+
+   mutable std::mutex runsMutex;
+   RunList runs;  // Oldest first
+   std::thread compactor;
+   std::atomic<bool> compacting;
+   std::atomic<size_t> nextRunId;
+   size_t instanceId;
+
+   void put(const T& key, bool tombstone);
+   RunList snapshot() const;
+   std::string runPath();
+   void maybeCompact();
+   bool pickRuns(const RunList& current, bool force, size_t& first, size_t& last) const;
+   bool compactRuns(RunList inputs, size_t first);
+
+   template<typename Emit>
+   void merge(const std::vector<LsmEntry<T>>& recent, std::vector<RunCursor<T, Compare>>& cursors,
+              const T* high, Emit emit) const;
+
+public:
+   explicit LsmTree(const LsmOptions& options = LsmOptions());
+   ~LsmTree();
+
+   LsmTree(const LsmTree&) = delete;
+   LsmTree& operator=(const LsmTree&) = delete;
+
+   // Core operations (remove writes a tombstone, it does not look the key up)
+   void insert(const T& key) { put(key, false); }
+   void remove(const T& key) { put(key, true); }
+   bool contains(const T& key) const;
+
+   // Live keys in [low, high], ascending, merged across the memtable and all runs
+   template<typename Visitor>
+   void scan(const T& low, const T& high, Visitor&& visit) const;
+
+   // Maintenance
+   bool flush();    // Write the memtable out as a run; false (memtable kept) on I/O failure
+   void compact();  // Merge all runs now and wait for it
+   bool flushFailed() const { return flushError; }  // Writes are kept in memory meanwhile
+   bool readFailed() const { return readError; }    // Some lookup or scan saw an unreadable run
+   size_t runCount() const;
+   size_t memtableBytes() const { return memtableUsage; }
+   size_t indexBytes() const;  // Fence keys and Bloom filters held in memory
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// RUN: Block (fence index) whose key range may hold key - binary search over fence keys
+template<typename T, typename Compare>
+size_t SortedRun<T, Compare>::block(const T& key) const {
+   // Last fence key <= key (block 0 if key precedes every fence)
+   size_t low = 0;
+   size_t high = fenceKeys.size();
+   while (high - low > 1) {
+      const size_t middle = low + (high - low) / 2;
+      if (comp(key, fenceKeys[middle]) < 0) {
+         high = middle;
+      } else {
+         low = middle;
+      }
+   }
+   return low;
+}
+
+// RUN: Point lookup - Bloom filter, then one block scan
+template<typename T, typename Compare>
+RunLookup SortedRun<T, Compare>::find(const T& key, size_t hash) const {
+   if (count == 0 || !bloom.mayContain(hash) || comp(key, fenceKeys.front()) < 0) {
+      return RunLookup::ABSENT;
+   }
+
+   const size_t index = block(key);
+   const size_t first = index * fenceInterval;
+   const size_t records = (count - first < fenceInterval) ? count - first : fenceInterval;
+
+   std::lock_guard<std::mutex> lock(streamMutex);
+   if (!stream.is_open()) {
+      stream.open(filePath, std::ios::binary);
+      if (!stream.is_open()) return RunLookup::FAILED;
+   }
+   stream.clear();
+   stream.seekg(static_cast<std::streamoff>(fenceOffsets[index]));
+
+   // The block holds exactly records entries, so running short is an error
+   T stored;
+   for (size_t i = 0; i < records; i++) {
+      const int flag = stream.get();
+      if (flag == EOF || !KeyCodec<T>::decode(stream, stored)) return RunLookup::FAILED;
+
+      const auto order = comp(stored, key);
+      if (order == 0) return flag ? RunLookup::DELETED : RunLookup::LIVE;
+      if (order > 0) break;  // Passed where key would be
+   }
+   return RunLookup::ABSENT;
+}
+
+template<typename T, typename Compare>
+size_t SortedRun<T, Compare>::memoryBytes() const {
+   size_t bytes = fenceKeys.size() * (sizeof(T) + sizeof(uint64_t)) + bloom.memoryBytes();
+   for (const T& key : fenceKeys) {
+      bytes += KeyHeapSize<T>::bytes(key);
+   }
+   return bytes;
+}
+
+// CURSOR: Jump to the block that may hold low, then skip smaller records
+template<typename T, typename Compare>
+void RunCursor<T, Compare>::seek(const T& low) {
+   if (run->count == 0) return;
+
+   const size_t index = run->block(low);
+   in.clear();
+   in.seekg(static_cast<std::streamoff>(run->fenceOffsets[index]));
+   remaining = run->count - index * run->fenceInterval;
+
+   next();
+   while (ok && run->comp(current, low) < 0) {
+      next();
+   }
+}
+
+template<typename T, typename Compare>
+void RunCursor<T, Compare>::next() {
+   ok = false;
+   if (remaining == 0) return;
+
+   // Records are left, so an unopened file or a short read is an error, not the end
+   const int flag = in.get();
+   if (flag == EOF || !KeyCodec<T>::decode(in, current)) {
+      error = true;
+      return;
+   }
+
+   deleted = (flag != 0);
+   remaining--;
+   ok = true;
+}
+
+// WRITER: Records are buffered and written in large chunks
+template<typename T, typename Compare>
+RunWriter<T, Compare>::RunWriter(const std::string& path, const Compare& comp,
+                                 const LsmOptions& options, size_t expectedKeys)
+   : run(new SortedRun<T, Compare>(path, comp, options.fenceInterval)),
+     out(path, std::ios::binary | std::ios::trunc), offset(0) {
+   if (options.bloomBitsPerKey > 0) {
+      run->bloom = BloomFilter(expectedKeys, options.bloomBitsPerKey);
+   }
+}
+
+template<typename T, typename Compare>
+void RunWriter<T, Compare>::append(const T& key, bool tombstone) {
+   // First record of each block becomes a fence
+   if (run->count % run->fenceInterval == 0) {
+      run->fenceKeys.push_back(key);
+      run->fenceOffsets.push_back(offset + buffer.size());
+   }
+
+   if (run->bloom.memoryBytes() > 0) {
+      run->bloom.add(std::hash<T>()(key));
+   }
+
+   buffer.push_back(tombstone ? 1 : 0);
+   KeyCodec<T>::encode(buffer, key);
+   run->count++;
+
+   if (buffer.size() >= (1 << 20)) {
+      out.write(buffer.data(), buffer.size());
+      offset += buffer.size();
+      buffer.clear();
+   }
+}
+
+template<typename T, typename Compare>
+std::shared_ptr<SortedRun<T, Compare>> RunWriter<T, Compare>::finish() {
+   out.write(buffer.data(), buffer.size());
+   out.close();
+
+   // A failed run deletes its partial file when released here
+   if (!out) return nullptr;
+   return std::shared_ptr<SortedRun<T, Compare>>(run.release());
+}
+
+// CONSTRUCTOR & DESTRUCTOR
+template<typename T, typename Compare>
+LsmTree<T, Compare>::LsmTree(const LsmOptions& options)
+   : options(options), memtableUsage(0), flushAt(options.memtableBytes), flushError(false),
+     readError(false), compacting(false), nextRunId(0) {
+   static std::atomic<size_t> instances(0);
+   instanceId = instances++;
+
+   if (this->options.fenceInterval == 0) {
+      this->options.fenceInterval = 1;
+   }
+   if (this->options.maxRuns == 0) {
+      this->options.maxRuns = 1;
+   }
+}
+
+template<typename T, typename Compare>
+LsmTree<T, Compare>::~LsmTree() {
+   // Run files are removed as the last references to them go away
+   if (compactor.joinable()) {
+      compactor.join();
+   }
+}
+
+// WRITE: Upsert into the memtable, flushing once over budget
+template<typename T, typename Compare>
+void LsmTree<T, Compare>::put(const T& key, bool tombstone) {
+   const LsmEntry<T> entry{key, tombstone};
+
+   if (const LsmEntry<T>* existing = memtable.find(entry)) {
+      existing->tombstone = tombstone;  // Overwrite in place, nothing new allocated
+   } else {
+      memtable.insert(entry);
+      memtableUsage += sizeof(Node<LsmEntry<T>>) + KeyHeapSize<T>::bytes(key);
+   }
+
+   // After a failed flush, wait for another memtable's worth of writes before retrying
+   // rather than rewriting the whole (growing) memtable on every write
+   if (memtableUsage >= flushAt && !flush()) {
+      flushAt = memtableUsage + options.memtableBytes;
+   }
+}
+
+// FLUSH: Write the memtable out as the newest run
+template<typename T, typename Compare>
+bool LsmTree<T, Compare>::flush() {
+   if (memtable.isEmpty()) return true;
+
+   // With no older runs, tombstones have nothing left to hide
+   const bool dropTombstones = runCount() == 0;
+
+   RunWriter<T, Compare> writer(runPath(), comp, options, memtable.size());
+   memtable.inorder([&writer, dropTombstones](const LsmEntry<T>& entry) {
+      if (!(dropTombstones && entry.tombstone)) {
+         writer.append(entry.key, entry.tombstone);
+      }
+   });
+
+   std::shared_ptr<Run> run = writer.finish();
+   flushError = !run;
+   if (!run) return false;
+
+   {
+      std::lock_guard<std::mutex> lock(runsMutex);
+      runs.push_back(run);
+   }
+
+   memtable.clear();
+   memtableUsage = 0;
+   flushAt = options.memtableBytes;
+
+   maybeCompact();
+   return true;
+}
+
+// READ: Memtable first, then runs from newest to oldest
+template<typename T, typename Compare>
+bool LsmTree<T, Compare>::contains(const T& key) const {
+   if (const LsmEntry<T>* entry = memtable.find(LsmEntry<T>{key, false})) {
+      return !entry->tombstone;
+   }
+
+   const RunList current = snapshot();
+   const size_t hash = std::hash<T>()(key);
+   for (auto run = current.rbegin(); run != current.rend(); ++run) {
+      const RunLookup result = (*run)->find(key, hash);
+      if (result == RunLookup::FAILED) {
+         readError = true;
+         return false;
+      }
+      if (result != RunLookup::ABSENT) return result == RunLookup::LIVE;
+   }
+   return false;
+}
+
+// SCAN: k-way merge of the memtable slice and a cursor per run
+template<typename T, typename Compare>
+template<typename Visitor>
+void LsmTree<T, Compare>::scan(const T& low, const T& high, Visitor&& visit) const {
+   std::vector<LsmEntry<T>> recent;
+   memtable.inorderRange(LsmEntry<T>{low, false}, LsmEntry<T>{high, false},
+                         [&recent](const LsmEntry<T>& entry) {
+      recent.push_back(entry);
+   });
+
+   const RunList current = snapshot();
+   std::vector<RunCursor<T, Compare>> cursors;
+   cursors.reserve(current.size());
+   for (auto run = current.rbegin(); run != current.rend(); ++run) {
+      cursors.emplace_back(**run);
+      cursors.back().seek(low);
+   }
+
+   merge(recent, cursors, &high, [&visit](const T& key, bool tombstone) {
+      if (!tombstone) visit(key);
+   });
+
+   for (const RunCursor<T, Compare>& cursor : cursors) {
+      if (cursor.failed()) readError = true;
+   }
+}
+
+// MERGE: Emit each key once, in order, as seen by its newest source.
+// Sources by priority: recent (memtable) first, then cursors (newest run first). Cursors sit in
+// a min-heap, so each key costs O(log runs) comparisons rather than one per run.
+template<typename T, typename Compare>
+template<typename Emit>
+void LsmTree<T, Compare>::merge(const std::vector<LsmEntry<T>>& recent,
+                                std::vector<RunCursor<T, Compare>>& cursors,
+                                const T* high, Emit emit) const {
+   // Heap order: smaller key first, then the newer run (lower index)
+   auto after = [this, &cursors](size_t a, size_t b) {
+      const auto order = comp(cursors[a].key(), cursors[b].key());
+      return order > 0 || (order == 0 && a > b);
+   };
+
+   std::vector<size_t> heap;
+   heap.reserve(cursors.size());
+   for (size_t i = 0; i < cursors.size(); i++) {
+      if (cursors[i].valid()) heap.push_back(i);
+   }
+   std::make_heap(heap.begin(), heap.end(), after);
+
+   size_t position = 0;
+
+   while (true) {
+      // Smallest current key; strict comparison keeps the memtable on ties
+      const T* best = nullptr;
+      bool bestTombstone = false;
+
+      if (position < recent.size()) {
+         best = &recent[position].key;
+         bestTombstone = recent[position].tombstone;
+      }
+      if (!heap.empty()) {
+         const RunCursor<T, Compare>& cursor = cursors[heap.front()];
+         if (best == nullptr || comp(cursor.key(), *best) < 0) {
+            best = &cursor.key();
+            bestTombstone = cursor.tombstone();
+         }
+      }
+
+      if (best == nullptr || (high != nullptr && comp(*high, *best) < 0)) return;
+
+      // Copy: advancing the sources below overwrites what best points to
+      const T key = *best;
+      emit(key, bestTombstone);
+
+      // Older copies of the same key are shadowed
+      if (position < recent.size() && comp(recent[position].key, key) == 0) {
+         position++;
+      }
+      while (!heap.empty() && comp(cursors[heap.front()].key(), key) == 0) {
+         std::pop_heap(heap.begin(), heap.end(), after);
+         RunCursor<T, Compare>& cursor = cursors[heap.back()];
+         cursor.next();
+         if (cursor.valid()) {
+            std::push_heap(heap.begin(), heap.end(), after);
+         } else {
+            heap.pop_back();
+         }
+      }
+   }
+}
+
+// COMPACTION: Merge in the background once compactionTrigger runs exist. When flushes outpace
+// it and more than maxRuns pile up, the writer waits for the running compaction and then merges
+// in the foreground until the count is back down: lookups touch every run and scans open a file
+// per run, so the run count has to stay bounded.
+template<typename T, typename Compare>
+void LsmTree<T, Compare>::maybeCompact() {
+   while (runCount() > options.maxRuns) {
+      if (compactor.joinable()) {
+         compactor.join();
+      }
+
+      const RunList current = snapshot();
+      size_t first = 0;
+      size_t last = 0;
+      if (current.size() <= options.maxRuns || !pickRuns(current, true, first, last)) break;
+
+      compacting = true;
+      RunList inputs(current.begin() + first, current.begin() + last + 1);
+      if (!compactRuns(std::move(inputs), first)) break;  // I/O failure: let writes go on
+   }
+
+   if (compacting || runCount() < options.compactionTrigger) return;
+
+   const RunList current = snapshot();
+   size_t first = 0;
+   size_t last = 0;
+   if (!pickRuns(current, false, first, last)) return;
+
+   if (compactor.joinable()) {
+      compactor.join();  // Previous compaction already finished
+   }
+
+   compacting = true;
+   RunList inputs(current.begin() + first, current.begin() + last + 1);
+   compactor = std::thread(&LsmTree::compactRuns, this, std::move(inputs), first);
+}
+
+// COMPACTION: Size-tiered choice. Walking back from each run towards older ones, an older run
+// joins while it is at most sizeRatio times the runs gathered so far; the first group of two or
+// more (newest first) is picked. Small fresh runs merge with each other, and a big old run is
+// only rewritten once the newer data has grown comparable to it. With force, runs that no size
+// tier groups fall back to the two newest.
+template<typename T, typename Compare>
+bool LsmTree<T, Compare>::pickRuns(const RunList& current, bool force, size_t& first,
+                                   size_t& last) const {
+   for (last = current.size(); last-- > 1;) {
+      first = last;
+      size_t gathered = current[last]->size();
+      while (first > 0 && current[first - 1]->size() <= options.sizeRatio * gathered) {
+         first--;
+         gathered += current[first]->size();
+      }
+      if (first != last) return true;
+   }
+
+   if (!force || current.size() < 2) return false;
+   first = current.size() - 2;
+   last = current.size() - 1;
+   return true;
+}
+
+template<typename T, typename Compare>
+void LsmTree<T, Compare>::compact() {
+   if (compactor.joinable()) {
+      compactor.join();
+   }
+   if (runCount() < 2) return;
+
+   compacting = true;
+   compactRuns(snapshot(), 0);
+}
+
+// COMPACTION: Merge consecutive runs, runs[first] onwards, into one. Tombstones are dropped
+// only when nothing older exists (first == 0). Flushes only append and one compaction runs at
+// a time, so the inputs are still at the same positions when the result is swapped in.
+// Returns false, leaving the inputs in place, if a run could not be read or written.
+template<typename T, typename Compare>
+bool LsmTree<T, Compare>::compactRuns(RunList inputs, size_t first) {
+   const bool dropTombstones = first == 0;
+
+   size_t expectedKeys = 0;
+   std::vector<RunCursor<T, Compare>> cursors;
+   cursors.reserve(inputs.size());
+   for (auto run = inputs.rbegin(); run != inputs.rend(); ++run) {
+      cursors.emplace_back(**run);
+      expectedKeys += (*run)->size();
+   }
+
+   RunWriter<T, Compare> writer(runPath(), comp, options, expectedKeys);
+   merge(std::vector<LsmEntry<T>>(), cursors, nullptr,
+         [&writer, dropTombstones](const T& key, bool tombstone) {
+      if (!(dropTombstones && tombstone)) writer.append(key, tombstone);
+   });
+   std::shared_ptr<Run> merged = writer.finish();
+
+   // A cursor that stopped early would silently drop the rest of its run
+   for (const RunCursor<T, Compare>& cursor : cursors) {
+      if (cursor.failed()) {
+         readError = true;
+         merged.reset();
+      }
+   }
+
+   // On I/O failure the inputs simply stay in place
+   if (merged) {
+      std::lock_guard<std::mutex> lock(runsMutex);
+      const auto position = runs.begin() + first;
+      runs.erase(position, position + inputs.size());
+      if (merged->size() > 0) {
+         runs.insert(runs.begin() + first, merged);
+      }
+   }
+
+   compacting = false;
+   return merged != nullptr;
+}
+
+// UTILITY: Runs list copy, so readers never hold the lock while doing I/O
+template<typename T, typename Compare>
+typename LsmTree<T, Compare>::RunList LsmTree<T, Compare>::snapshot() const {
+   std::lock_guard<std::mutex> lock(runsMutex);
+   return runs;
+}
+
+template<typename T, typename Compare>
+std::string LsmTree<T, Compare>::runPath() {
+   return options.directory + "/lsm-" + std::to_string(instanceId) + "-run-"
+        + std::to_string(nextRunId++) + ".sst";
+}
+
+template<typename T, typename Compare>
+size_t LsmTree<T, Compare>::runCount() const {
+   std::lock_guard<std::mutex> lock(runsMutex);
+   return runs.size();
+}
+
+template<typename T, typename Compare>
+size_t LsmTree<T, Compare>::indexBytes() const {
+   size_t bytes = 0;
+   for (const std::shared_ptr<Run>& run : snapshot()) {
+      bytes += run->memoryBytes();
+   }
+   return bytes;
+}
+
+
+#endif // LSM_TREE_HH
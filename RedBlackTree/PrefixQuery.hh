@@ -0,0 +1,166 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef PREFIX_QUERY_HH
+#define PREFIX_QUERY_HH
+
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "AdaptiveRadixTree.hh"
+#include "RedBlackTree.hh"
+
+// Prefix queries on string trees ordered lexicographically (std::less or ThreeWayCompare).
+// Keys starting with p form one contiguous run in sorted order, from the first key >= p up to the
+// first key that no longer starts with p, so a query costs O(log n + k) for k matches.
+// Trees keep duplicates next to each other: queries report each distinct key once (countPrefix()
+// still counts every copy), and skipping the extra copies is part of the O(k).
+
+// Visit distinct keys starting with prefix in sorted order, at most limit of them
+template<typename Compare, typename Balance, typename Visitor>
+void visitPrefix(const RedBlackTree<std::string, Compare, Balance>& tree, const std::string& prefix,
+                 Visitor&& visit, size_t limit = std::numeric_limits<size_t>::max()) {
+   if (limit == 0) return;
+
+   size_t visited = 0;
+   const std::string* last = nullptr;  // Nodes do not move during the walk
+   tree.inorderFrom(prefix, [&](const std::string& key) {
+      if (key.compare(0, prefix.size(), prefix) != 0) return false;  // Past the run
+      if (last != nullptr && key == *last) return true;               // Another copy
+
+      last = &key;
+      visit(key);
+      return ++visited < limit;
+   });
+}
+
+template<typename Compare, typename Balance>
+std::vector<std::string> prefixRange(const RedBlackTree<std::string, Compare, Balance>& tree,
+                                     const std::string& prefix,
+                                     size_t limit = std::numeric_limits<size_t>::max()) {
+   std::vector<std::string> result;
+   visitPrefix(tree, prefix, [&result](const std::string& key) {
+      result.push_back(key);
+   }, limit);
+   return result;
+}
+
+// Top-k autocomplete: the k distinct keys starting with prefix inserted most often, most
+// frequent first (ties in sorted order). Walks the whole run - O(log n + m log k) for m matches;
+// AdaptiveRadixTree::topCompletions() prunes by subtree counts instead.
+template<typename Compare, typename Balance>
+std::vector<Completion> topCompletions(const RedBlackTree<std::string, Compare, Balance>& tree,
+                                       const std::string& prefix, size_t k) {
+   TopCompletions top(k);
+   if (k == 0) return top.take();
+
+   const std::string* current = nullptr;
+   size_t copies = 0;
+   tree.inorderFrom(prefix, [&](const std::string& key) {
+      if (key.compare(0, prefix.size(), prefix) != 0) return false;
+
+      if (current != nullptr && key == *current) {
+         copies++;
+      } else {
+         if (current != nullptr) top.offer(*current, copies);
+         current = &key;
+         copies = 1;
+      }
+      return true;
+   });
+   if (current != nullptr) {
+      top.offer(*current, copies);
+   }
+   return top.take();
+}
+
+// Smallest string above every string starting with prefix: drop trailing 0xFF bytes and bump
+// the last remaining one. Returns false when no such bound exists ("" or all 0xFF).
+inline bool prefixUpperBound(const std::string& prefix, std::string& bound) {
+   bound = prefix;
+   while (!bound.empty() && static_cast<unsigned char>(bound.back()) == 0xFF) {
+      bound.pop_back();
+   }
+   if (bound.empty()) return false;
+
+   bound.back() = static_cast<char>(static_cast<unsigned char>(bound.back()) + 1);
+   return true;
+}
+
+// Number of keys starting with prefix. Weight-balanced trees rank both bounds in O(log n);
+// other policies count the run, O(log n + k).
+template<typename Compare, typename Balance>
+size_t countPrefix(const RedBlackTree<std::string, Compare, Balance>& tree,
+                   const std::string& prefix) {
+   if constexpr (std::is_same<Balance, WeightBalance>::value) {
+      std::string bound;
+      const size_t end = prefixUpperBound(prefix, bound) ? tree.countLess(bound) : tree.size();
+      return end - tree.countLess(prefix);
+   } else {
+      size_t count = 0;
+      tree.inorderFrom(prefix, [&](const std::string& key) {
+         if (key.compare(0, prefix.size(), prefix) != 0) return false;
+         count++;  // Every copy
+         return true;
+      });
+      return count;
+   }
+}
+
+// String tree with an ART companion index over the same keys: ordered operations stay on the
+// tree, prefix queries go to the radix tree and no longer depend on the number of keys.
+// Every key is stored twice, so expect roughly double the memory of the plain tree.
+template<typename Compare = ThreeWayCompare<std::string>, typename Balance = RedBlackBalance>
+class PrefixIndexedTree {
+private:
+   RedBlackTree<std::string, Compare, Balance> words;
+   AdaptiveRadixTree index;
+
+public:
+   // Core operations - O(log n) on the tree plus O(key length) on the index
+   void insert(const std::string& key) {
+      words.insert(key);
+      index.insert(key);
+   }
+
+   bool remove(const std::string& key) {
+      if (!words.remove(key)) return false;
+      index.remove(key);
+      return true;
+   }
+
+   bool contains(const std::string& key) const { return index.contains(key); }
+
+   // Prefix queries answered by the index
+   size_t countPrefix(const std::string& prefix) const { return index.countPrefix(prefix); }
+
+   template<typename Visitor>
+   void visitPrefix(const std::string& prefix, Visitor&& visit,
+                    size_t limit = std::numeric_limits<size_t>::max()) const {
+      index.visitPrefix(prefix, visit, limit);
+   }
+
+   std::vector<std::string> prefixRange(const std::string& prefix,
+                                        size_t limit = std::numeric_limits<size_t>::max()) const {
+      return index.prefixRange(prefix, limit);
+   }
+
+   std::vector<Completion> topCompletions(const std::string& prefix, size_t k) const {
+      return index.topCompletions(prefix, k);
+   }
+
+   // Utility operations
+   const RedBlackTree<std::string, Compare, Balance>& tree() const { return words; }
+   bool isEmpty() const { return words.isEmpty(); }
+   size_t size() const { return words.size(); }
+   void clear() {
+      words.clear();
+      index.clear();
+   }
+};
+
+
+#endif // PREFIX_QUERY_HH
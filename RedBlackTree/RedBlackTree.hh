@@ -6,159 +6,656 @@
 #ifndef RED_BLACK_TREE_HH
 #define RED_BLACK_TREE_HH
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "BalancePolicies.hh"
 
-// Color enumeration for nodes
-enum class Color {
-   RED,
-   BLACK
-};
-
-template<typename T>
-class Node {
+// Balance data (color, height, ...) comes from the policy's NodeBase
+template<typename T, typename Balance = RedBlackBalance>
+class Node : public Balance::NodeBase {
 public:
    T data;
-   Color color;
    Node* parent;
    Node* left;
    Node* right;
    
    // Constructor for regular nodes
    Node(const T& value) 
-      : data(value), color(Color::RED), 
+      : data(value), 
       parent(nullptr), left(nullptr), right(nullptr) {}
 };
 
-// Template class for Red-Black Tree
-template<typename T, typename Compare = std::less<T>>
+// Detects keys with a compare() member (std::string style)
+template<typename T, typename = void>
+struct HasCompareMethod : std::false_type {};
+
+template<typename T>
+struct HasCompareMethod<T, decltype(void(std::declval<const T&>().compare(std::declval<const T&>())))>
+   : std::true_type {};
+
+// Detects keys usable with std::hash (needed by the lookup cache)
+template<typename T, typename = void>
+struct IsHashable : std::false_type {};
+
+template<typename T>
+struct IsHashable<T, decltype(void(std::hash<T>()(std::declval<const T&>())))> : std::true_type {};
+
+// Three-way comparator: one call yields <0, 0 or >0 (less, equivalent, greater).
+// Any comparator returning int or a std::*_ordering (e.g. std::compare_three_way) also works.
+template<typename T>
+struct ThreeWayCompare {
+   int operator()(const T& a, const T& b) const {
+      if constexpr (HasCompareMethod<T>::value) {
+         return a.compare(b);
+      } else {
+         return (a < b) ? -1 : ((b < a) ? 1 : 0);
+      }
+   }
+};
+
+// Heap bytes owned by a key beyond sizeof(T); specialize for types that allocate
+template<typename T>
+struct KeyHeapSize {
+   static constexpr bool allocates = false;
+   static size_t bytes(const T&) { return 0; }
+};
+
+template<typename CharT, typename Traits, typename Alloc>
+struct KeyHeapSize<std::basic_string<CharT, Traits, Alloc>> {
+   static constexpr bool allocates = true;
+   static size_t bytes(const std::basic_string<CharT, Traits, Alloc>& key) {
+      // Short strings are stored inline (SSO) and own no heap block
+      static const size_t inlineCapacity = std::basic_string<CharT, Traits, Alloc>().capacity();
+      return key.capacity() > inlineCapacity ? (key.capacity() + 1) * sizeof(CharT) : 0;
+   }
+};
+
+// Memory report returned by RedBlackTree::memoryUsage()
+struct MemoryUsage {
+   size_t nodeBytes;           // sizeof(Node) for every stored element
+   size_t keyHeapBytes;        // Heap owned by the keys themselves (see KeyHeapSize)
+   size_t sentinelBytes;       // Tree object plus the NIL sentinel node
+   size_t cacheBytes;          // Lookup cache lines (0 while the cache is disabled)
+   size_t allocatorSlackBytes; // Estimated malloc headers and rounding on every node block
+   size_t allocations;         // Nodes allocated over the tree's lifetime (insert, copy)
+   size_t deallocations;       // Nodes released over the tree's lifetime (remove, clear)
+
+   size_t total() const {
+      return nodeBytes + keyHeapBytes + sentinelBytes + cacheBytes + allocatorSlackBytes;
+   }
+};
+
+// Template class for Red-Black Tree (the balancing scheme is a policy, see BalancePolicies.hh)
+template<typename T, typename Compare = std::less<T>, typename Balance = RedBlackBalance>
 class RedBlackTree {
 private:
-   Node<T>* root;
-   Node<T>* NIL;
+   // Policies rotate and read root/NIL while restoring balance
+   friend struct TreeAccess;
+
+   Node<T, Balance>* root;
+   Node<T, Balance>* NIL;
+   Node<T, Balance>* leftmost;   // Cached minimum (NIL when empty)
+   Node<T, Balance>* rightmost;  // Cached maximum (NIL when empty)
    Compare comp;
    size_t nodeCount;
+   size_t allocations;
+   size_t deallocations;
+   size_t rotations;
+
+   // Lookup cache: each set is one cache line holding four recently found nodes and the hashes
+   // of their keys. Nodes never move once allocated (rotations and removals relink them), so an
+   // entry only goes stale when its node is freed.
+   static constexpr size_t CACHE_WAYS = 4;
+   struct alignas(64) CacheLine {
+      size_t hashes[CACHE_WAYS];
+      Node<T, Balance>* nodes[CACHE_WAYS];  // nullptr = empty way
+   };
+
+   CacheLine* cacheLines;  // nullptr while the cache is disabled
+   size_t cacheMask;       // Number of lines - 1 (a power of two)
+   mutable size_t cacheHits;
+   mutable size_t cacheMisses;
    
+   // Comparator returning an ordering instead of bool: one comparison per level
+   static constexpr bool threeWay = !std::is_same<
+      decltype(std::declval<const Compare&>()(std::declval<const T&>(), std::declval<const T&>())),
+      bool>::value;
+
+   bool less(const T& a, const T& b) const;
+
    // Helper methods for tree operations
-   void rotateLeft(Node<T>* x);
-   void rotateRight(Node<T>* x);
-   void insertFixup(Node<T>* z);
-   void deleteFixup(Node<T>* x);
-   void transplant(Node<T>* u, Node<T>* v);
+   void rotateLeft(Node<T, Balance>* x);
+   void rotateRight(Node<T, Balance>* x);
+   void transplant(Node<T, Balance>* u, Node<T, Balance>* v);
+   void removeNode(Node<T, Balance>* z);
    
+   // Node allocation (counted for memoryUsage)
+   Node<T, Balance>* createNode(const T& value);
+   void freeNode(Node<T, Balance>* node);
+   void createSentinel();
+   void resetCache();
+
    // Utility methods
-   Node<T>* minimum(Node<T>* node) const;
-   Node<T>* maximum(Node<T>* node) const;
-   Node<T>* search(Node<T>* node, const T& value) const;
-   void destroyTree(Node<T>* node);
+   Node<T, Balance>* minimum(Node<T, Balance>* node) const;
+   Node<T, Balance>* maximum(Node<T, Balance>* node) const;
+   Node<T, Balance>* search(Node<T, Balance>* node, const T& value) const;
+   Node<T, Balance>* lowerBound(const T& value) const;
+   Node<T, Balance>* cachedSearch(const T& value) const;
+   void forgetCached(Node<T, Balance>* node);
+   static size_t cacheSlot(size_t hash);
+   Node<T, Balance>* successor(Node<T, Balance>* node) const;
+   void destroyTree(Node<T, Balance>* node);
+   void cloneTree(const Node<T, Balance>* node, const Node<T, Balance>* otherNIL,
+                  Node<T, Balance>* parent, Node<T, Balance>*& slot);
+   size_t keyHeapBytes(const Node<T, Balance>* node) const;
+   size_t heightHelper(const Node<T, Balance>* node) const;
+   size_t depthSum(const Node<T, Balance>* node, size_t depth) const;
    
    // Traversal helpers
-   void inorderHelper(Node<T>* node, void (*callback)(const T&)) const;
+   template<typename Callback>
+   void inorderHelper(Node<T, Balance>* node, Callback& callback) const;
+   template<typename Callback>
+   void rangeHelper(Node<T, Balance>* node, const T& low, const T& high, Callback& callback) const;
 
 public:
    RedBlackTree();
    ~RedBlackTree();
    
-   // Disable copy
-   RedBlackTree(const RedBlackTree&) = delete;
-   RedBlackTree& operator=(const RedBlackTree&) = delete;
+   // Copy clones the structure as-is (no comparisons, no rebalancing) - O(n)
+   RedBlackTree(const RedBlackTree& other);
+   RedBlackTree& operator=(const RedBlackTree& other);
+
+   // Move hands over the nodes together with their sentinel - O(1), no allocation. The
+   // moved-from tree is empty and allocates a new sentinel on its next insert.
+   RedBlackTree(RedBlackTree&& other) noexcept;
+   RedBlackTree& operator=(RedBlackTree&& other) noexcept;
+   void swap(RedBlackTree& other) noexcept;
    
    // Core operations
    void insert(const T& value);
    bool remove(const T& value);
    bool contains(const T& value) const;
+   const T* find(const T& value) const;  // Stored element equivalent to value, or nullptr
+   size_t countLess(const T& value) const;  // Values ordered before value (WeightBalance only)
+
+   // Priority-queue operations: min()/max() require a non-empty tree - O(1)
+   const T& min() const { return leftmost->data; }
+   const T& max() const { return rightmost->data; }
+   bool popMin();
+   bool popMin(T& out);
+   bool popMax();
+   bool popMax(T& out);
    
    // Utility operations
    bool isEmpty() const { return root == NIL; }
    size_t size() const { return nodeCount; }
    void clear();
+   MemoryUsage memoryUsage() const;
+
+   // Shape statistics (to compare balancing policies)
+   size_t height() const { return heightHelper(root); }
+   double averageDepth() const;
+   size_t rotationCount() const { return rotations; }
+
+   // Hot-key cache in front of contains()/find(), off by default. Holds at least entries
+   // nodes. Copy construction starts without one, copy assignment keeps the target's (emptied)
+   // and moves carry the source's along. Lookups then write to the cache, so concurrent
+   // readers need their own synchronization.
+   void enableLookupCache(size_t entries = 1024);
+   void disableLookupCache();
+   size_t cacheHitCount() const { return cacheHits; }
+   size_t cacheMissCount() const { return cacheMisses; }
    
    // Traversal
-   void inorder(void (*callback)(const T&)) const;
+   template<typename Callback>
+   void inorder(Callback&& callback) const;
+   template<typename Callback>
+   void inorderRange(const T& low, const T& high, Callback&& callback) const;  // low <= x <= high
+   template<typename Callback>
+   void inorderFrom(const T& low, Callback&& callback) const;  // x >= low, until callback is false
 };
 
+// Same container with the other balancing policies
+template<typename T, typename Compare = std::less<T>>
+using AvlTree = RedBlackTree<T, Compare, AvlBalance>;
+
+template<typename T, typename Compare = std::less<T>>
+using WeightBalancedTree = RedBlackTree<T, Compare, WeightBalance>;
+
 // ======================================== IMPLEMENTATION =========================================
 
 // CONSTRUCTOR & DESTRUCTOR
-template<typename T, typename Compare>
-RedBlackTree<T, Compare>::RedBlackTree() : nodeCount(0) {
-   // Create sentinel NIL node (represents all leaves)
-   NIL = new Node<T>(T());
-   NIL->color = Color::BLACK;  // NIL is always black
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>::RedBlackTree()
+   : nodeCount(0), allocations(0), deallocations(0), rotations(0),
+     cacheLines(nullptr), cacheMask(0), cacheHits(0), cacheMisses(0) {
+   createSentinel();
+}
+
+// SENTINEL: Create NIL (represents all leaves) for an empty tree
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::createSentinel() {
+   NIL = new Node<T, Balance>(T());
+   Balance::initSentinel(NIL);  // e.g. NIL is always black
    NIL->parent = nullptr;
    NIL->left = nullptr;
    NIL->right = nullptr;
    
-   // Empty tree: root points to NIL
+   // Empty tree: root and cached extremes point to NIL
    root = NIL;
+   leftmost = NIL;
+   rightmost = NIL;
 }
 
-template<typename T, typename Compare>
-RedBlackTree<T, Compare>::~RedBlackTree() {
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>::~RedBlackTree() {
    destroyTree(root);
    delete NIL;
+   delete[] cacheLines;
+}
+
+// COPY: Clone other's structure node by node, keeping balance data
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>::RedBlackTree(const RedBlackTree& other)
+   : RedBlackTree() {
+   comp = other.comp;
+
+   // If a copy throws, the delegated constructor has finished, so ~RedBlackTree frees the partial clone
+   cloneTree(other.root, other.NIL, nullptr, root);
+   nodeCount = other.nodeCount;
+
+   if (root != NIL) {
+      leftmost = minimum(root);
+      rightmost = maximum(root);
+   }
+}
+
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>& RedBlackTree<T, Compare, Balance>::operator=(const RedBlackTree& other) {
+   if (this != &other) {
+      RedBlackTree copy(other);
+      swap(copy);
+
+      // Keep this tree's lookup cache; its entries pointed at the nodes now in copy
+      std::swap(cacheLines, copy.cacheLines);
+      std::swap(cacheMask, copy.cacheMask);
+      std::swap(cacheHits, copy.cacheHits);
+      std::swap(cacheMisses, copy.cacheMisses);
+      resetCache();
+   }
+   return *this;
+}
+
+// MOVE: Take over other's nodes, sentinel and cache. other is left empty without a sentinel
+// (root == NIL == nullptr): every read sees an empty tree and insert() allocates a new one.
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>::RedBlackTree(RedBlackTree&& other) noexcept
+   : root(other.root), NIL(other.NIL), leftmost(other.leftmost), rightmost(other.rightmost),
+     comp(std::move(other.comp)), nodeCount(other.nodeCount), allocations(other.allocations),
+     deallocations(other.deallocations), rotations(other.rotations),
+     cacheLines(other.cacheLines), cacheMask(other.cacheMask), cacheHits(other.cacheHits),
+     cacheMisses(other.cacheMisses) {
+   other.root = nullptr;
+   other.NIL = nullptr;
+   other.leftmost = nullptr;
+   other.rightmost = nullptr;
+   other.nodeCount = 0;
+   other.cacheLines = nullptr;
+   other.cacheMask = 0;
+}
+
+template<typename T, typename Compare, typename Balance>
+RedBlackTree<T, Compare, Balance>& RedBlackTree<T, Compare, Balance>::operator=(RedBlackTree&& other) noexcept {
+   // Release our nodes first so other is left empty, as after move construction
+   clear();
+   swap(other);
+   return *this;
+}
+
+// SWAP: Leaves point to their own tree's NIL, so the sentinel travels with the nodes
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::swap(RedBlackTree& other) noexcept {
+   std::swap(root, other.root);
+   std::swap(NIL, other.NIL);
+   std::swap(leftmost, other.leftmost);
+   std::swap(rightmost, other.rightmost);
+   std::swap(comp, other.comp);
+   std::swap(nodeCount, other.nodeCount);
+   std::swap(allocations, other.allocations);
+   std::swap(deallocations, other.deallocations);
+   std::swap(rotations, other.rotations);
+   std::swap(cacheLines, other.cacheLines);  // Entries point into the nodes they came with
+   std::swap(cacheMask, other.cacheMask);
+   std::swap(cacheHits, other.cacheHits);
+   std::swap(cacheMisses, other.cacheMisses);
+}
+
+// ALLOCATION: Every element node goes through these (the sentinel does not)
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::createNode(const T& value) {
+   Node<T, Balance>* node = new Node<T, Balance>(value);
+   allocations++;
+   return node;
+}
+
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::freeNode(Node<T, Balance>* node) {
+   delete node;
+   deallocations++;
 }
 
 
 // UTILITY: Destroy tree recursively (post-order)
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::destroyTree(Node<T>* node) {
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::destroyTree(Node<T, Balance>* node) {
    if (node == NIL) return;
 
    // Delete children first, then parent
    destroyTree(node->left);
    destroyTree(node->right);
-   delete node;
+   freeNode(node);
+}
+
+// UTILITY: Clone subtree (pre-order), remapping other's NIL to ours
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::cloneTree(const Node<T, Balance>* node, const Node<T, Balance>* otherNIL,
+                                         Node<T, Balance>* parent, Node<T, Balance>*& slot) {
+   if (node == otherNIL) return;
+
+   Node<T, Balance>* copy = createNode(node->data);
+   static_cast<typename Balance::NodeBase&>(*copy) = *node;  // Color, height, ...
+   copy->parent = parent;
+   copy->left = NIL;
+   copy->right = NIL;
+
+   // Link before recursing so a throwing copy leaves a destructible partial tree
+   slot = copy;
+   cloneTree(node->left, otherNIL, copy, copy->left);
+   cloneTree(node->right, otherNIL, copy, copy->right);
 }
 
 // UTILITY: Clear entire tree
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::clear() {
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::clear() {
    destroyTree(root);
    root = NIL;
+   leftmost = NIL;
+   rightmost = NIL;
    nodeCount = 0;
+   resetCache();
+}
+
+// MEMORY: Footprint breakdown - O(1), or O(n) when keys own heap memory
+template<typename T, typename Compare, typename Balance>
+MemoryUsage RedBlackTree<T, Compare, Balance>::memoryUsage() const {
+   // glibc-style chunk: 8-byte header, 16-byte granularity, 32-byte minimum
+   const size_t block = sizeof(Node<T, Balance>) + sizeof(size_t);
+   const size_t chunk = block < 32 ? 32 : (block + 15) & ~static_cast<size_t>(15);
+
+   MemoryUsage usage;
+   usage.nodeBytes = nodeCount * sizeof(Node<T, Balance>);
+   usage.keyHeapBytes = KeyHeapSize<T>::allocates ? keyHeapBytes(root) : 0;
+   usage.sentinelBytes = sizeof(*this) + sizeof(Node<T, Balance>);
+   usage.cacheBytes = cacheLines != nullptr ? (cacheMask + 1) * sizeof(CacheLine) : 0;
+   usage.allocatorSlackBytes = (nodeCount + 1) * (chunk - sizeof(Node<T, Balance>));
+   usage.allocations = allocations;
+   usage.deallocations = deallocations;
+   return usage;
+}
+
+template<typename T, typename Compare, typename Balance>
+size_t RedBlackTree<T, Compare, Balance>::keyHeapBytes(const Node<T, Balance>* node) const {
+   if (node == NIL) return 0;
+   return KeyHeapSize<T>::bytes(node->data) + keyHeapBytes(node->left) + keyHeapBytes(node->right);
 }
 
 // SEARCH: Find node with given value
-template<typename T, typename Compare>
-Node<T>* RedBlackTree<T, Compare>::search(Node<T>* node, const T& value) const {
-   // Base case: not found (NIL) or found (equal)
-   if (node == NIL || node->data == value) {
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::search(Node<T, Balance>* node, const T& value) const {
+   if constexpr (threeWay) {
+      // A single comparison both detects equivalence and picks the branch
+      while (node != NIL) {
+         const auto order = comp(value, node->data);
+         if (order == 0) return node;
+         node = (order < 0) ? node->left : node->right;
+      }
       return node;
+   } else {
+      // Base case: not found (NIL) or found (equal)
+      if (node == NIL || node->data == value) {
+         return node;
+      }
+
+      // Recursive search: left or right based on comparison
+      if (comp(value, node->data)) {
+         return search(node->left, value);
+      } else {
+         return search(node->right, value);
+      }
    }
+}
 
-   // Recursive search: left or right based on comparison
-   if (comp(value, node->data)) {
-      return search(node->left, value);
-   } else {
-      return search(node->right, value);
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::contains(const T& value) const {
+   return cachedSearch(value) != NIL;
+}
+
+template<typename T, typename Compare, typename Balance>
+const T* RedBlackTree<T, Compare, Balance>::find(const T& value) const {
+   Node<T, Balance>* node = cachedSearch(value);
+   return node != NIL ? &node->data : nullptr;
+}
+
+// LOOKUP CACHE: Allocate (at least) entries ways, rounded up to a power-of-two number of lines
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::enableLookupCache(size_t entries) {
+   static_assert(IsHashable<T>::value, "enableLookupCache() needs std::hash<T>");
+
+   size_t lines = 1;
+   while (lines * CACHE_WAYS < entries) {
+      lines <<= 1;
+   }
+
+   delete[] cacheLines;
+   cacheLines = new CacheLine[lines]();
+   cacheMask = lines - 1;
+   cacheHits = 0;
+   cacheMisses = 0;
+}
+
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::disableLookupCache() {
+   delete[] cacheLines;
+   cacheLines = nullptr;
+   cacheMask = 0;
+}
+
+// LOOKUP CACHE: Drop every entry, keeping the configuration
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::resetCache() {
+   if (cacheLines != nullptr) {
+      std::fill(cacheLines, cacheLines + cacheMask + 1, CacheLine());
    }
 }
 
-template<typename T, typename Compare>
-bool RedBlackTree<T, Compare>::contains(const T& value) const {
-   return search(root, value) != NIL;
+// LOOKUP CACHE: Mix the key hash so that identity hashes (integers) still spread over the lines
+template<typename T, typename Compare, typename Balance>
+size_t RedBlackTree<T, Compare, Balance>::cacheSlot(size_t hash) {
+   hash ^= hash >> 33;
+   hash *= static_cast<size_t>(0xff51afd7ed558ccdULL);
+   return hash ^ (hash >> 33);
+}
+
+// SEARCH: Probe the key's cache line before descending; a hit costs the line plus the node
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::cachedSearch(const T& value) const {
+   if constexpr (IsHashable<T>::value) {
+      if (cacheLines != nullptr) {
+         const size_t hash = std::hash<T>()(value);
+         CacheLine& line = cacheLines[cacheSlot(hash) & cacheMask];
+
+         for (size_t way = 0; way < CACHE_WAYS; way++) {
+            Node<T, Balance>* node = line.nodes[way];
+            if (node != nullptr && line.hashes[way] == hash) {
+               bool equivalent;
+               if constexpr (threeWay) {
+                  equivalent = comp(value, node->data) == 0;
+               } else {
+                  equivalent = node->data == value;  // Same test as search()
+               }
+
+               if (equivalent) {
+                  // Move up one way: keys hit repeatedly settle at the front of the line
+                  if (way > 0) {
+                     std::swap(line.hashes[way], line.hashes[way - 1]);
+                     std::swap(line.nodes[way], line.nodes[way - 1]);
+                  }
+                  cacheHits++;
+                  return node;
+               }
+            }
+         }
+
+         cacheMisses++;
+         Node<T, Balance>* node = search(root, value);
+         if (node != NIL) {
+            // New keys take the first empty way, else the last one, so a burst of one-off
+            // lookups only churns the tail of the line and cannot push out the hot keys
+            size_t way = 0;
+            while (way < CACHE_WAYS - 1 && line.nodes[way] != nullptr) {
+               way++;
+            }
+            line.hashes[way] = hash;
+            line.nodes[way] = node;
+         }
+         return node;
+      }
+   }
+   return search(root, value);
+}
+
+// LOOKUP CACHE: Drop entries pointing at node; must run while node->data is intact
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::forgetCached(Node<T, Balance>* node) {
+   if constexpr (IsHashable<T>::value) {
+      if (cacheLines == nullptr) return;
+
+      CacheLine& line = cacheLines[cacheSlot(std::hash<T>()(node->data)) & cacheMask];
+      for (size_t way = 0; way < CACHE_WAYS; way++) {
+         if (line.nodes[way] == node) line.nodes[way] = nullptr;
+      }
+   }
+}
+
+// SEARCH: First node not ordered before value (NIL if none)
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::lowerBound(const T& value) const {
+   Node<T, Balance>* result = NIL;
+   Node<T, Balance>* node = root;
+
+   while (node != NIL) {
+      if (less(node->data, value)) {
+         node = node->right;
+      } else {
+         result = node;  // Candidate; a smaller one may be on the left
+         node = node->left;
+      }
+   }
+   return result;
+}
+
+// RANK: Subtree sizes let the descent count everything left of the path - O(log n)
+template<typename T, typename Compare, typename Balance>
+size_t RedBlackTree<T, Compare, Balance>::countLess(const T& value) const {
+   static_assert(std::is_same<Balance, WeightBalance>::value,
+                 "countLess() needs subtree sizes (WeightBalance policy)");
+
+   size_t count = 0;
+   Node<T, Balance>* node = root;
+   while (node != NIL) {
+      if (less(node->data, value)) {
+         count += node->left->size + 1;
+         node = node->right;
+      } else {
+         node = node->left;
+      }
+   }
+   return count;
+}
+
+// COMPARE: Strict "a before b" for either comparator flavor
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::less(const T& a, const T& b) const {
+   if constexpr (threeWay) {
+      return comp(a, b) < 0;
+   } else {
+      return comp(a, b);
+   }
 }
 
 // UTILITY: Find minimum/maximum in subtree
-template<typename T, typename Compare>
-Node<T>* RedBlackTree<T, Compare>::minimum(Node<T>* node) const {
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::minimum(Node<T, Balance>* node) const {
    while (node->left != NIL) {
       node = node->left;
    }
    return node;
 }
 
-template<typename T, typename Compare>
-Node<T>* RedBlackTree<T, Compare>::maximum(Node<T>* node) const {
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::maximum(Node<T, Balance>* node) const {
    while (node->right != NIL) {
       node = node->right;
    }
    return node;
 }
 
+// UTILITY: Inorder successor through parent links (NIL after the maximum)
+template<typename T, typename Compare, typename Balance>
+Node<T, Balance>* RedBlackTree<T, Compare, Balance>::successor(Node<T, Balance>* node) const {
+   if (node->right != NIL) {
+      return minimum(node->right);
+   }
+
+   // Climb until we come up from a left child
+   Node<T, Balance>* parent = node->parent;
+   while (parent != nullptr && node == parent->right) {
+      node = parent;
+      parent = parent->parent;
+   }
+   return parent != nullptr ? parent : NIL;
+}
+
+// STATISTICS: Height and average node depth (root has depth 0) - O(n)
+template<typename T, typename Compare, typename Balance>
+size_t RedBlackTree<T, Compare, Balance>::heightHelper(const Node<T, Balance>* node) const {
+   if (node == NIL) return 0;
+
+   const size_t left = heightHelper(node->left);
+   const size_t right = heightHelper(node->right);
+   return 1 + (left > right ? left : right);
+}
+
+template<typename T, typename Compare, typename Balance>
+size_t RedBlackTree<T, Compare, Balance>::depthSum(const Node<T, Balance>* node, size_t depth) const {
+   if (node == NIL) return 0;
+   return depth + depthSum(node->left, depth + 1) + depthSum(node->right, depth + 1);
+}
+
+template<typename T, typename Compare, typename Balance>
+double RedBlackTree<T, Compare, Balance>::averageDepth() const {
+   if (nodeCount == 0) return 0.0;
+   return static_cast<double>(depthSum(root, 0)) / nodeCount;
+}
+
 // TRAVERSAL: Inorder (sorted order)
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::inorderHelper(Node<T>* node, void (*callback)(const T&)) const {
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RedBlackTree<T, Compare, Balance>::inorderHelper(Node<T, Balance>* node, Callback& callback) const {
    if (node == NIL) return;
 
    // Left -> Root -> Right
@@ -167,16 +664,48 @@ void RedBlackTree<T, Compare>::inorderHelper(Node<T>* node, void (*callback)(con
    inorderHelper(node->right, callback);
 }
 
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::inorder(void (*callback)(const T&)) const {
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RedBlackTree<T, Compare, Balance>::inorder(Callback&& callback) const {
     inorderHelper(root, callback);
 }
 
+// TRAVERSAL: Inorder restricted to [low, high], skipping subtrees outside the bounds
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RedBlackTree<T, Compare, Balance>::rangeHelper(Node<T, Balance>* node, const T& low,
+                                                    const T& high, Callback& callback) const {
+   if (node == NIL) return;
+
+   const bool aboveLow = !less(node->data, low);
+   const bool belowHigh = !less(high, node->data);
+
+   if (aboveLow) rangeHelper(node->left, low, high, callback);
+   if (aboveLow && belowHigh) callback(node->data);
+   if (belowHigh) rangeHelper(node->right, low, high, callback);
+}
+
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RedBlackTree<T, Compare, Balance>::inorderRange(const T& low, const T& high,
+                                                     Callback&& callback) const {
+   rangeHelper(root, low, high, callback);
+}
+
+// TRAVERSAL: Inorder from the first value >= low; stops as soon as callback returns false
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RedBlackTree<T, Compare, Balance>::inorderFrom(const T& low, Callback&& callback) const {
+   for (Node<T, Balance>* node = lowerBound(low); node != NIL; node = successor(node)) {
+      if (!callback(node->data)) return;
+   }
+}
+
 // ROTATION: Left Rotation
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::rotateLeft(Node<T>* x) {
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::rotateLeft(Node<T, Balance>* x) {
    // Set y (will become new parent)
-   Node<T>* y = x->right; 
+   Node<T, Balance>* y = x->right; 
    
    // Turn y's left subtree into x's right subtree
    x->right = y->left;
@@ -197,12 +726,15 @@ void RedBlackTree<T, Compare>::rotateLeft(Node<T>* x) {
    // Put x on y's left
    y->left = x;
    x->parent = y;
+
+   rotations++;
+   Balance::rotated(x, y);  // x is now below y
 }
 
 // ROTATION: Right Rotation
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::rotateRight(Node<T>* y) {
-   Node<T>* x = y->left;  // Set x (will become new parent)
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::rotateRight(Node<T, Balance>* y) {
+   Node<T, Balance>* x = y->left;  // Set x (will become new parent)
    
    // Turn x's right subtree into y's left subtree
    y->left = x->right;
@@ -223,24 +755,34 @@ void RedBlackTree<T, Compare>::rotateRight(Node<T>* y) {
    // Put y on x's right
    x->right = y;
    y->parent = x;
+
+   rotations++;
+   Balance::rotated(y, x);  // y is now below x
 }
 
 // INSERT: Add new value to tree
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::insert(const T& value) {
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::insert(const T& value) {
+   // A moved-from tree gets its sentinel back on first use
+   if (NIL == nullptr) {
+      createSentinel();
+   }
+
    // Create new red node
-   Node<T>* z = new Node<T>(value);
+   Node<T, Balance>* z = createNode(value);
    z->left = NIL;
    z->right = NIL;
    
    // Standard BST insertion
-   Node<T>* y = nullptr;  // Trailing pointer (will be parent of z)
-   Node<T>* x = root;      // Current node
+   Node<T, Balance>* y = nullptr;  // Trailing pointer (will be parent of z)
+   Node<T, Balance>* x = root;      // Current node
+   bool goLeft = false;    // Last direction taken (side of y where z goes)
    
    // Find correct position for new node
    while (x != NIL) {
       y = x;
-      if (comp(z->data, x->data)) {
+      goLeft = less(z->data, x->data);
+      if (goLeft) {
          x = x->left;   // Go left
       } else {
          x = x->right;  // Go right
@@ -253,83 +795,25 @@ void RedBlackTree<T, Compare>::insert(const T& value) {
    // Insert as root or as child
    if (y == nullptr) {
       root = z;  // Tree was empty
-   } else if (comp(z->data, y->data)) {
+      leftmost = z;
+      rightmost = z;
+   } else if (goLeft) {
       y->left = z;   // Insert as left child
+      if (y == leftmost) leftmost = z;
    } else {
       y->right = z;  // Insert as right child
+      if (y == rightmost) rightmost = z;
    }
    
    nodeCount++;
    
-   // Fix Red-Black properties
-   insertFixup(z);
-}
-
-// INSERT FIXUP: Restore Red-Black properties after insertion
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::insertFixup(Node<T>* z) {
-   // Continue while parent is red (violation of property 4)
-   while (z->parent != nullptr && z->parent->color == Color::RED) {
-      
-      // Parent is LEFT child of grandparent
-      if (z->parent == z->parent->parent->left) {
-         Node<T>* uncle = z->parent->parent->right;  // Uncle is right child
-         
-         // CASE 1: Uncle is RED
-         if (uncle->color == Color::RED) {
-            z->parent->color = Color::BLACK;         // Recolor parent
-            uncle->color = Color::BLACK;              // Recolor uncle
-            z->parent->parent->color = Color::RED;    // Recolor grandparent
-            z = z->parent->parent;                    // Move up to grandparent
-         }
-         // Uncle is BLACK
-         else {
-            // CASE 2: z is RIGHT child (convert to Case 3)
-            if (z == z->parent->right) {
-               z = z->parent;
-               rotateLeft(z);  // Transform to Case 3
-            }
-            
-            // CASE 3: z is LEFT child
-            z->parent->color = Color::BLACK;          // Recolor parent
-            z->parent->parent->color = Color::RED;    // Recolor grandparent
-            rotateRight(z->parent->parent);           // Rotate right
-         }
-      }
-      // Parent is RIGHT child of grandparent (symmetric)
-      else {
-         Node<T>* uncle = z->parent->parent->left;  // Uncle is left child
-         
-         // CASE 1: Uncle is RED
-         if (uncle->color == Color::RED) {
-            z->parent->color = Color::BLACK;
-            uncle->color = Color::BLACK;
-            z->parent->parent->color = Color::RED;
-            z = z->parent->parent;
-         }
-         // Uncle is BLACK
-         else {
-            // CASE 2: z is LEFT child (convert to Case 3)
-            if (z == z->parent->left) {
-               z = z->parent;
-               rotateRight(z);  // Transform to Case 3
-            }
-            
-            // CASE 3: z is RIGHT child
-            z->parent->color = Color::BLACK;
-            z->parent->parent->color = Color::RED;
-            rotateLeft(z->parent->parent);
-         }
-      }
-   }
-   
-   // Ensure root is always black (property 2)
-   root->color = Color::BLACK;
+   // Fix balance (Red-Black properties by default)
+   Balance::insertFixup(*this, z);
 }
 
 // UTILITY: Transplant - Replace subtree u with subtree v
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::transplant(Node<T>* u, Node<T>* v) {
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::transplant(Node<T, Balance>* u, Node<T, Balance>* v) {
    // Update parent's child pointer
    if (u->parent == nullptr) {
       root = v;  // u was root
@@ -345,17 +829,73 @@ void RedBlackTree<T, Compare>::transplant(Node<T>* u, Node<T>* v) {
 
 
 // DELETE: Remove value from tree
-template<typename T, typename Compare>
-bool RedBlackTree<T, Compare>::remove(const T& value) {
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::remove(const T& value) {
    // Find node to delete
-   Node<T>* z = search(root, value);
+   Node<T, Balance>* z = search(root, value);
    if (z == NIL) {
       return false;  // Value not found
    }
-   
-   Node<T>* y = z;  // Node to be deleted (or moved)
-   Node<T>* x;      // Node that replaces y
-   Color yOriginalColor = y->color;
+
+   forgetCached(z);
+   removeNode(z);
+   return true;
+}
+
+// PRIORITY QUEUE: Unlink the cached extreme directly, no search
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::popMin() {
+   if (root == NIL) return false;
+
+   forgetCached(leftmost);
+   removeNode(leftmost);
+   return true;
+}
+
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::popMin(T& out) {
+   if (root == NIL) return false;
+
+   forgetCached(leftmost);
+   out = std::move(leftmost->data);
+   removeNode(leftmost);
+   return true;
+}
+
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::popMax() {
+   if (root == NIL) return false;
+
+   forgetCached(rightmost);
+   removeNode(rightmost);
+   return true;
+}
+
+template<typename T, typename Compare, typename Balance>
+bool RedBlackTree<T, Compare, Balance>::popMax(T& out) {
+   if (root == NIL) return false;
+
+   forgetCached(rightmost);
+   out = std::move(rightmost->data);
+   removeNode(rightmost);
+   return true;
+}
+
+// DELETE: Unlink node z and restore balance
+template<typename T, typename Compare, typename Balance>
+void RedBlackTree<T, Compare, Balance>::removeNode(Node<T, Balance>* z) {
+   // Advance cached extremes: the minimum has no left child, so its successor is the
+   // minimum of its right subtree or else its parent (symmetric for the maximum)
+   if (z == leftmost) {
+      leftmost = (z->right != NIL) ? minimum(z->right) : (z->parent ? z->parent : NIL);
+   }
+   if (z == rightmost) {
+      rightmost = (z->left != NIL) ? maximum(z->left) : (z->parent ? z->parent : NIL);
+   }
+
+   Node<T, Balance>* y = z;  // Node to be deleted (or moved)
+   Node<T, Balance>* x;      // Node that replaces y
+   typename Balance::NodeBase yOriginal = *y;  // Balance data of the unlinked position
    
    // CASE 1: z has no left child
    if (z->left == NIL) {
@@ -370,7 +910,7 @@ bool RedBlackTree<T, Compare>::remove(const T& value) {
    // CASE 3: z has two children
    else {
       y = minimum(z->right);  // Find successor (min of right subtree)
-      yOriginalColor = y->color;
+      yOriginal = *y;
       x = y->right;
       
       // Successor is direct child of z
@@ -388,98 +928,14 @@ bool RedBlackTree<T, Compare>::remove(const T& value) {
       transplant(z, y);
       y->left = z->left;
       y->left->parent = y;
-      y->color = z->color;  // Keep z's color
+      static_cast<typename Balance::NodeBase&>(*y) = *z;  // Keep z's color (height, ...)
    }
    
-   delete z;
+   freeNode(z);
    nodeCount--;
    
-   // Fix Red-Black properties if we deleted a BLACK node
-   if (yOriginalColor == Color::BLACK) {
-      deleteFixup(x);
-   }
-   
-   return true;
-}
-
-// DELETE FIXUP: Restore Red-Black properties after deletion
-template<typename T, typename Compare>
-void RedBlackTree<T, Compare>::deleteFixup(Node<T>* x) {
-   // Continue while x is not root and x is black (double black)
-   while (x != root && x->color == Color::BLACK) {
-      
-      // x is LEFT child
-      if (x == x->parent->left) {
-         Node<T>* w = x->parent->right;  // Sibling
-         
-         // CASE 1: Sibling is RED
-         if (w->color == Color::RED) {
-            w->color = Color::BLACK;           // Recolor sibling
-            x->parent->color = Color::RED;     // Recolor parent
-            rotateLeft(x->parent);             // Rotate left
-            w = x->parent->right;              // Update sibling
-         }
-         
-         // CASE 2: Sibling BLACK + both children BLACK
-         if (w->left->color == Color::BLACK && w->right->color == Color::BLACK) {
-            w->color = Color::RED;  // Recolor sibling
-            x = x->parent;          // Move problem up
-         }
-         else {
-            // CASE 3: Sibling BLACK + left RED, right BLACK
-            if (w->right->color == Color::BLACK) {
-               w->left->color = Color::BLACK;   // Recolor left child
-               w->color = Color::RED;           // Recolor sibling
-               rotateRight(w);                  // Rotate right
-               w = x->parent->right;            // Update sibling
-            }
-            
-            // CASE 4: Sibling BLACK + right RED
-            w->color = x->parent->color;        // Copy parent's color
-            x->parent->color = Color::BLACK;    // Recolor parent
-            w->right->color = Color::BLACK;     // Recolor right child
-            rotateLeft(x->parent);              // Rotate left
-            x = root;                           // Terminate loop
-         }
-      }
-      // x is RIGHT child (symmetric cases)
-      else {
-         Node<T>* w = x->parent->left;  // Sibling
-         
-         // CASE 1: Sibling is RED
-         if (w->color == Color::RED) {
-            w->color = Color::BLACK;
-            x->parent->color = Color::RED;
-            rotateRight(x->parent);
-            w = x->parent->left;
-         }
-         
-         // CASE 2: Sibling BLACK + both children BLACK
-         if (w->right->color == Color::BLACK && w->left->color == Color::BLACK) {
-            w->color = Color::RED;
-            x = x->parent;
-         }
-         else {
-            // CASE 3: Sibling BLACK + right RED, left BLACK
-            if (w->left->color == Color::BLACK) {
-               w->right->color = Color::BLACK;
-               w->color = Color::RED;
-               rotateLeft(w);
-               w = x->parent->left;
-            }
-            
-            // CASE 4: Sibling BLACK + left RED
-            w->color = x->parent->color;
-            x->parent->color = Color::BLACK;
-            w->left->color = Color::BLACK;
-            rotateRight(x->parent);
-            x = root;
-         }
-      }
-   }
-   
-   // Ensure x is black
-   x->color = Color::BLACK;
+   // Fix balance (Red-Black: only needed if we deleted a BLACK node)
+   Balance::deleteFixup(*this, x, yOriginal);
 }
 
 
@@ -0,0 +1,112 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef SERIALIZATION_HH
+#define SERIALIZATION_HH
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <type_traits>
+
+// Binary encoding of keys for files written by the tree wrappers (sorted runs, logs).
+// encode() appends to a byte buffer, decode() reads one key back and returns false on a
+// short or failed read. Specialize KeyCodec for your own key types.
+template<typename T, typename = void>
+struct KeyCodec;
+
+// Arithmetic keys: raw bytes in host byte order
+template<typename T>
+struct KeyCodec<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+   static void encode(std::string& out, const T& key) {
+      out.append(reinterpret_cast<const char*>(&key), sizeof(T));
+   }
+
+   static bool decode(std::istream& in, T& key) {
+      return static_cast<bool>(in.read(reinterpret_cast<char*>(&key), sizeof(T)));
+   }
+};
+
+// Strings: 32-bit length followed by the characters
+template<typename CharT, typename Traits, typename Alloc>
+struct KeyCodec<std::basic_string<CharT, Traits, Alloc>> {
+   static void encode(std::string& out, const std::basic_string<CharT, Traits, Alloc>& key) {
+      const uint32_t length = static_cast<uint32_t>(key.size());
+      out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+      out.append(reinterpret_cast<const char*>(key.data()), key.size() * sizeof(CharT));
+   }
+
+   static bool decode(std::istream& in, std::basic_string<CharT, Traits, Alloc>& key) {
+      uint32_t length = 0;
+      if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) return false;
+
+      key.resize(length);
+      return static_cast<bool>(in.read(reinterpret_cast<char*>(&key[0]), length * sizeof(CharT)));
+   }
+};
+
+// Fixed-width integers in host byte order (record headers)
+inline void encodeU32(std::string& out, uint32_t value) {
+   out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void encodeU64(std::string& out, uint64_t value) {
+   out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline bool decodeU32(std::istream& in, uint32_t& value) {
+   return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+inline bool decodeU64(std::istream& in, uint64_t& value) {
+   return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+// Variable-length unsigned integers: 7 bits per byte, high bit set on all but the last byte
+inline void encodeVarint(std::string& out, uint64_t value) {
+   while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+   }
+   out.push_back(static_cast<char>(value));
+}
+
+inline bool decodeVarint(std::istream& in, uint64_t& value) {
+   value = 0;
+   for (int shift = 0; shift < 64; shift += 7) {
+      const int byte = in.get();
+      if (byte == std::char_traits<char>::eof()) return false;
+
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return true;
+   }
+   return false;  // More than 10 bytes: corrupt
+}
+
+// CRC-32 (IEEE 802.3); pass a previous result as crc to checksum data in pieces
+inline uint32_t crc32(const char* data, size_t length, uint32_t crc = 0) {
+   static const std::array<uint32_t, 256> table = [] {
+      std::array<uint32_t, 256> entries{};
+      for (uint32_t i = 0; i < 256; i++) {
+         uint32_t value = i;
+         for (int bit = 0; bit < 8; bit++) {
+            value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+         }
+         entries[i] = value;
+      }
+      return entries;
+   }();
+
+   crc = ~crc;
+   for (size_t i = 0; i < length; i++) {
+      crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+   }
+   return ~crc;
+}
+
+
+#endif // SERIALIZATION_HH
@@ -0,0 +1,314 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#ifndef WORKLOAD_TRACE_HH
+#define WORKLOAD_TRACE_HH
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "RedBlackTree.hh"
+#include "Serialization.hh"
+
+// Operations captured in a trace
+enum class TraceOp : uint8_t {
+   INSERT = 1,
+   REMOVE = 2,
+   CONTAINS = 3,  // contains() and find()
+   RANGE = 4,     // inorderRange(low, high)
+   END = 0xFF
+};
+
+// How keys are written to a trace (neither mode stores the keys themselves)
+enum class TraceKeys : uint32_t {
+   SYNTHETIC = 1,  // Key ids, replayed as each key's sorted rank: equality and order are kept
+   HASHED = 2      // 64-bit hash of the encoded key: equality is kept, order (ranges) is not
+};
+
+// One replayable operation
+struct TraceRecord {
+   TraceOp op;
+   uint64_t time;  // Nanoseconds since recording started
+   uint64_t key;   // Rank (SYNTHETIC) or hash (HASHED); low end of a range
+   uint64_t high;  // High end of a range (RANGE only)
+};
+
+// A trace loaded in memory by loadTrace()
+struct WorkloadTrace {
+   TraceKeys keys;
+   uint64_t distinctKeys;  // Number of ranks in use (0 for HASHED traces)
+   std::vector<TraceRecord> records;
+};
+
+// File layout: [u32 magic][u32 version][u32 key mode], then records
+// [u8 op][varint ns since previous record][varint key]([varint high key] for RANGE),
+// an END byte and, for SYNTHETIC traces, [varint id count][varint rank] for every key id.
+static constexpr uint32_t TRACE_MAGIC = 0x43525442;  // "BTRC"
+static constexpr uint32_t TRACE_VERSION = 1;
+
+// UTILITY: FNV-1a over the encoded key (stable across runs, unlike std::hash)
+inline uint64_t traceHash(const std::string& bytes) {
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   for (char byte : bytes) {
+      hash ^= static_cast<unsigned char>(byte);
+      hash *= 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+// UTILITY: "a before b" for bool and three-way comparators alike
+template<typename Compare, typename T>
+bool traceLess(const Compare& comp, const T& a, const T& b) {
+   if constexpr (std::is_same<decltype(comp(a, b)), bool>::value) {
+      return comp(a, b);
+   } else {
+      return comp(a, b) < 0;
+   }
+}
+
+// RedBlackTree that logs every operation to a compact binary trace. The trace can be shared
+// instead of the data and replayed against any tree configuration (see workload_replay.cc).
+// Keys must have a KeyCodec (Serialization.hh); it is used to identify them, never written.
+// Not thread-safe; the trace is complete once close() (or the destructor) has run.
+template<typename T, typename Compare = std::less<T>, typename Balance = RedBlackBalance>
+class RecordingTree {
+private:
+   using Tree = RedBlackTree<T, Compare, Balance>;
+   using Clock = std::chrono::steady_clock;
+
+   static constexpr size_t FLUSH_BYTES = 1 << 20;
+
+   Tree data;
+   std::FILE* trace;
+   TraceKeys mode;
+   std::string buffer;                              // Records not yet written
+   std::string encoded;                             // Scratch for the key being identified
+   std::unordered_map<std::string, uint64_t> ids;   // Encoded key -> id (SYNTHETIC)
+   std::vector<T> keys;                             // Key of every id, ranked on close()
+   Clock::time_point last;                          // Time of the previous record
+   size_t recorded;
+   bool failed;
+
+   uint64_t keyId(const T& key);
+   void record(TraceOp op, const T& key, const T* high = nullptr);
+   void flush();
+
+public:
+   explicit RecordingTree(const std::string& path, TraceKeys mode = TraceKeys::SYNTHETIC);
+   ~RecordingTree() { close(); }
+
+   RecordingTree(const RecordingTree&) = delete;
+   RecordingTree& operator=(const RecordingTree&) = delete;
+
+   // Core operations (recorded, then applied)
+   void insert(const T& value);
+   bool remove(const T& value);
+   bool contains(const T& value);
+   const T* find(const T& value);
+
+   template<typename Callback>
+   void inorderRange(const T& low, const T& high, Callback&& callback);
+
+   // Read-only access to the tree (not recorded)
+   const Tree& tree() const { return data; }
+   size_t size() const { return data.size(); }
+
+   // Trace
+   bool close();  // Write the END record and key ranks; false if any write failed
+   bool isOpen() const { return trace != nullptr; }
+   size_t recordedOperations() const { return recorded; }
+};
+
+// ======================================== IMPLEMENTATION =========================================
+
+// CONSTRUCTOR: Create the trace file and write its header
+template<typename T, typename Compare, typename Balance>
+RecordingTree<T, Compare, Balance>::RecordingTree(const std::string& path, TraceKeys mode)
+   : trace(std::fopen(path.c_str(), "wb")), mode(mode), last(Clock::now()), recorded(0),
+     failed(trace == nullptr) {
+   encodeU32(buffer, TRACE_MAGIC);
+   encodeU32(buffer, TRACE_VERSION);
+   encodeU32(buffer, static_cast<uint32_t>(mode));
+}
+
+// CORE OPERATIONS: Record at arrival, so the timestamps follow the caller's pacing
+template<typename T, typename Compare, typename Balance>
+void RecordingTree<T, Compare, Balance>::insert(const T& value) {
+   record(TraceOp::INSERT, value);
+   data.insert(value);
+}
+
+template<typename T, typename Compare, typename Balance>
+bool RecordingTree<T, Compare, Balance>::remove(const T& value) {
+   record(TraceOp::REMOVE, value);
+   return data.remove(value);
+}
+
+template<typename T, typename Compare, typename Balance>
+bool RecordingTree<T, Compare, Balance>::contains(const T& value) {
+   record(TraceOp::CONTAINS, value);
+   return data.contains(value);
+}
+
+template<typename T, typename Compare, typename Balance>
+const T* RecordingTree<T, Compare, Balance>::find(const T& value) {
+   record(TraceOp::CONTAINS, value);
+   return data.find(value);
+}
+
+template<typename T, typename Compare, typename Balance>
+template<typename Callback>
+void RecordingTree<T, Compare, Balance>::inorderRange(const T& low, const T& high,
+                                                       Callback&& callback) {
+   record(TraceOp::RANGE, low, &high);
+   data.inorderRange(low, high, callback);
+}
+
+// RECORDING: Hash, or first-seen id remembered until close() ranks it
+template<typename T, typename Compare, typename Balance>
+uint64_t RecordingTree<T, Compare, Balance>::keyId(const T& key) {
+   encoded.clear();
+   KeyCodec<T>::encode(encoded, key);
+   if (mode == TraceKeys::HASHED) return traceHash(encoded);
+
+   const auto entry = ids.emplace(encoded, keys.size());
+   if (entry.second) {
+      keys.push_back(key);
+   }
+   return entry.first->second;
+}
+
+template<typename T, typename Compare, typename Balance>
+void RecordingTree<T, Compare, Balance>::record(TraceOp op, const T& key, const T* high) {
+   if (trace == nullptr) return;
+
+   const Clock::time_point now = Clock::now();
+   const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last);
+   last = now;
+
+   buffer.push_back(static_cast<char>(op));
+   encodeVarint(buffer, static_cast<uint64_t>(elapsed.count()));
+   encodeVarint(buffer, keyId(key));
+   if (high != nullptr) {
+      encodeVarint(buffer, keyId(*high));
+   }
+   recorded++;
+
+   if (buffer.size() >= FLUSH_BYTES) {
+      flush();
+   }
+}
+
+template<typename T, typename Compare, typename Balance>
+void RecordingTree<T, Compare, Balance>::flush() {
+   if (std::fwrite(buffer.data(), 1, buffer.size(), trace) != buffer.size()) {
+      failed = true;
+   }
+   buffer.clear();
+}
+
+// CLOSE: END record, then the rank of every key id under the tree's comparator
+template<typename T, typename Compare, typename Balance>
+bool RecordingTree<T, Compare, Balance>::close() {
+   if (trace == nullptr) return !failed;
+
+   buffer.push_back(static_cast<char>(TraceOp::END));
+
+   if (mode == TraceKeys::SYNTHETIC) {
+      const Compare comp{};
+      std::vector<uint64_t> order(keys.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+         return traceLess(comp, keys[a], keys[b]);
+      });
+
+      std::vector<uint64_t> rank(keys.size());
+      for (size_t i = 0; i < order.size(); i++) {
+         rank[order[i]] = i;
+      }
+
+      encodeVarint(buffer, rank.size());
+      for (uint64_t value : rank) {
+         encodeVarint(buffer, value);
+      }
+   }
+
+   flush();
+   if (std::fclose(trace) != 0) {
+      failed = true;
+   }
+   trace = nullptr;
+   return !failed;
+}
+
+// REPLAY: Load a complete trace, with SYNTHETIC ids already replaced by their ranks.
+// Returns false on a bad header, a truncated trace (no END record) or an unknown operation.
+inline bool loadTrace(const std::string& path, WorkloadTrace& trace) {
+   std::ifstream in(path, std::ios::binary);
+
+   uint32_t magic = 0;
+   uint32_t version = 0;
+   uint32_t keys = 0;
+   if (!in.is_open() || !decodeU32(in, magic) || magic != TRACE_MAGIC ||
+       !decodeU32(in, version) || version != TRACE_VERSION || !decodeU32(in, keys)) {
+      return false;
+   }
+
+   trace.keys = static_cast<TraceKeys>(keys);
+   trace.distinctKeys = 0;
+   trace.records.clear();
+
+   uint64_t time = 0;
+   while (true) {
+      const int op = in.get();
+      if (op == static_cast<int>(TraceOp::END)) break;
+      if (op < static_cast<int>(TraceOp::INSERT) || op > static_cast<int>(TraceOp::RANGE)) {
+         return false;  // End of file or corrupt byte
+      }
+
+      TraceRecord record{static_cast<TraceOp>(op), 0, 0, 0};
+      uint64_t delta = 0;
+      if (!decodeVarint(in, delta) || !decodeVarint(in, record.key)) return false;
+      if (record.op == TraceOp::RANGE && !decodeVarint(in, record.high)) return false;
+
+      time += delta;
+      record.time = time;
+      trace.records.push_back(record);
+   }
+
+   if (trace.keys != TraceKeys::SYNTHETIC) return trace.keys == TraceKeys::HASHED;
+
+   // Ids -> ranks
+   // Every id first appears in a record, so a larger count means a corrupt footer
+   if (!decodeVarint(in, trace.distinctKeys) || trace.distinctKeys > 2 * trace.records.size()) {
+      return false;
+   }
+
+   std::vector<uint64_t> rank(trace.distinctKeys);
+   for (uint64_t& value : rank) {
+      if (!decodeVarint(in, value)) return false;
+   }
+
+   for (TraceRecord& record : trace.records) {
+      const bool range = record.op == TraceOp::RANGE;
+      if (record.key >= rank.size() || (range && record.high >= rank.size())) return false;
+
+      record.key = rank[record.key];
+      if (range) {
+         record.high = rank[record.high];
+      }
+   }
+   return true;
+}
+
+
+#endif // WORKLOAD_TRACE_HH
@@ -0,0 +1,99 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "RedBlackTree.hh"
+#include "../Utils/performance.hh"
+
+// Run the same workload on one balancing policy and print its shape statistics
+template<typename Tree>
+void benchmarkPolicy(const std::string& name, const std::vector<std::string>& words) {
+   Tree tree;
+
+   // Insertion -------------------------------
+   Performance insertion(name + "-Insertion");
+
+   insertion.start();
+   for (const std::string& word : words) {
+      tree.insert(word);
+   }
+   insertion.stop();
+
+   insertion.print();
+
+   std::cout << name << ": height " << tree.height()
+             << ", average depth " << tree.averageDepth()
+             << ", rotations " << tree.rotationCount() << std::endl;
+
+
+   // Search (read-heavy: every word once) -----
+   Performance search(name + "-Search");
+
+   size_t found = 0;
+   search.start();
+   for (const std::string& word : words) {
+      found += tree.contains(word);
+   }
+   search.stop();
+
+   search.print();
+
+
+   // Remove (write-heavy: every other word) ---
+   Performance remove(name + "-Remove");
+
+   const size_t rotationsBefore = tree.rotationCount();
+   remove.start();
+   for (size_t i = 0; i < words.size(); i += 2) {
+      tree.remove(words[i]);
+   }
+   remove.stop();
+
+   remove.print();
+
+   std::cout << name << ": " << found << " found, "
+             << tree.rotationCount() - rotationsBefore << " rotations while removing" << std::endl;
+
+
+   // Pop min (scheduler-style drain) ---------
+   Performance popMin(name + "-PopMin");
+
+   popMin.start();
+   while (tree.popMin()) {
+   }
+   popMin.stop();
+
+   popMin.print();
+   std::cout << "---------------------------------------" << std::endl;
+}
+
+int main() {
+   // Open big file
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "1M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   // Load once so every policy sees the exact same input
+   std::vector<std::string> words;
+   std::string word;
+   while (file >> word) {
+      words.push_back(word);
+   }
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   benchmarkPolicy<RedBlackTree<std::string, ThreeWayCompare<std::string>>>("RedBlack", words);
+   benchmarkPolicy<AvlTree<std::string, ThreeWayCompare<std::string>>>("AVL", words);
+   benchmarkPolicy<WeightBalancedTree<std::string, ThreeWayCompare<std::string>>>("WeightBalanced", words);
+
+   return 0;
+}
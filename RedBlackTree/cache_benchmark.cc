@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "RedBlackTree.hh"
+#include "../Utils/performance.hh"
+
+using WordTree = RedBlackTree<std::string, ThreeWayCompare<std::string>>;
+
+// Zipf(s) ranks over [0, n): rank r is drawn with probability proportional to 1 / (r + 1)^s
+std::vector<size_t> zipfRanks(size_t n, double s, size_t count, std::mt19937& random) {
+   std::vector<double> cumulative(n);
+   double sum = 0;
+   for (size_t r = 0; r < n; r++) {
+      sum += 1.0 / std::pow(static_cast<double>(r + 1), s);
+      cumulative[r] = sum;
+   }
+
+   std::uniform_real_distribution<double> uniform(0, sum);
+   std::vector<size_t> ranks;
+   ranks.reserve(count);
+   for (size_t i = 0; i < count; i++) {
+      const auto it = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random));
+      ranks.push_back(it - cumulative.begin());
+   }
+   return ranks;
+}
+
+// Time the same lookups with the cache off (entries == 0) or on
+void benchmarkLookups(WordTree& tree, const std::vector<const std::string*>& lookups,
+                      const std::string& name, size_t entries) {
+   if (entries == 0) {
+      tree.disableLookupCache();
+   } else {
+      tree.enableLookupCache(entries);
+   }
+
+   Performance lookup(name);
+
+   size_t found = 0;
+   lookup.start();
+   for (const std::string* key : lookups) {
+      found += tree.contains(*key);
+   }
+   lookup.stop();
+
+   lookup.print();
+
+   if (entries != 0) {
+      const size_t hits = tree.cacheHitCount();
+      const size_t misses = tree.cacheMissCount();
+      std::cout << name << ": " << found << " found, hit rate "
+                << 100.0 * hits / (hits + misses) << "% (" << hits << " hits, "
+                << misses << " misses)" << std::endl;
+   }
+}
+
+int main() {
+   const size_t LOOKUPS = 10000000;
+
+   // Open big file
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "1M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   WordTree tree;
+   std::vector<std::string> words;
+   std::string word;
+   while (file >> word) {
+      tree.insert(word);
+      words.push_back(word);
+   }
+
+   // Hot words are spread over the key space rather than clustered in one subtree
+   std::mt19937 random(42);
+   std::shuffle(words.begin(), words.end(), random);
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   for (double skew : {0.8, 1.0, 1.2}) {
+      std::vector<const std::string*> lookups;
+      lookups.reserve(LOOKUPS);
+      for (size_t rank : zipfRanks(words.size(), skew, LOOKUPS, random)) {
+         lookups.push_back(&words[rank]);
+      }
+
+      const std::string label = "10M-Zipf" + std::to_string(skew).substr(0, 3);
+      benchmarkLookups(tree, lookups, label + "-NoCache", 0);
+      benchmarkLookups(tree, lookups, label + "-Cache1K", 1024);
+      benchmarkLookups(tree, lookups, label + "-Cache16K", 16384);
+      std::cout << "---------------------------------------" << std::endl;
+   }
+
+   return 0;
+}
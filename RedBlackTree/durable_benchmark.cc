@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "DurableTree.hh"
+#include "../Utils/performance.hh"
+
+// Delete the benchmark's checkpoint and log segments so every run starts empty
+void removeDurableFiles(const DurabilityOptions& options) {
+   const std::string prefix = options.name + ".";
+   std::error_code error;
+   for (const auto& entry : std::filesystem::directory_iterator(options.directory, error)) {
+      if (entry.path().filename().string().compare(0, prefix.size(), prefix) == 0) {
+         std::filesystem::remove(entry.path(), error);
+      }
+   }
+}
+
+int main() {
+   // Open big file
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "1M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   std::vector<std::string> words;
+   std::string word;
+   while (file >> word) {
+      words.push_back(word);
+   }
+
+   DurabilityOptions options;
+   options.directory = ".";
+   options.name = "benchmark";
+   options.checkpointInterval = 0;  // Checkpoint explicitly below
+   removeDurableFiles(options);
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   // In-memory baseline ----------------------
+   Performance memory("1M-Insertion-InMemory");
+
+   RedBlackTree<std::string> plain;
+   memory.start();
+   for (const std::string& value : words) {
+      plain.insert(value);
+   }
+   memory.stop();
+
+   memory.print();
+
+
+   // Logged insertion (group commit) ---------
+   {
+      DurableTree<std::string> durable(options);
+      Performance logged("1M-Insertion-Logged");
+
+      logged.start();
+      for (const std::string& value : words) {
+         durable.insert(value);
+      }
+      durable.commit();
+      logged.stop();
+
+      logged.print();
+
+
+      // Checkpoint ---------------------------
+      Performance checkpoint("1M-Checkpoint");
+
+      checkpoint.start();
+      durable.checkpoint();
+      checkpoint.stop();
+
+      checkpoint.print();
+
+      // A short tail of recent changes after the checkpoint
+      for (size_t i = 0; i < words.size() / 100; i++) {
+         durable.remove(words[i]);
+      }
+   }
+
+
+   // Recovery: checkpoint + log tail ---------
+   {
+      Performance recovery("1M-Recovery");
+
+      recovery.start();
+      DurableTree<std::string> recovered(options);
+      recovery.stop();
+
+      recovery.print();
+      std::cout << recovered.size() << " values, " << recovered.recoveredOperations()
+                << " log operations replayed" << std::endl;
+   }
+
+   removeDurableFiles(options);
+   return 0;
+}
@@ -0,0 +1,78 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include "IntervalTree.hh"
+#include "../Utils/performance.hh"
+
+int main() {
+   const int INTERVALS = 2000000;
+   const int QUERIES = 1000;
+   const long long TIMELINE = 1000000000LL;  // Time ranges are placed on [0, TIMELINE]
+
+   // Short random time ranges, generated once so both approaches see the same data
+   std::mt19937_64 random(42);
+   std::vector<Interval<long long>> ranges;
+   ranges.reserve(INTERVALS);
+   for (int i = 0; i < INTERVALS; i++) {
+      const long long start = random() % TIMELINE;
+      ranges.push_back({start, start + static_cast<long long>(random() % 100000)});
+   }
+
+   std::vector<long long> points;
+   for (int i = 0; i < QUERIES; i++) {
+      points.push_back(random() % TIMELINE);
+   }
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   // Insertion -------------------------------
+   IntervalTree<long long> tree;
+   Performance insertion("2M-Interval-Insertion");
+
+   insertion.start();
+   for (const Interval<long long>& range : ranges) {
+      tree.insert(range.low, range.high);
+   }
+   insertion.stop();
+
+   insertion.print();
+
+
+   // Stabbing queries (interval tree) --------
+   Performance stabbing("1K-Stabbing-IntervalTree");
+
+   size_t treeMatches = 0;
+   stabbing.start();
+   for (long long point : points) {
+      tree.visitOverlapping(point, point, [&treeMatches](const Interval<long long>&) {
+         treeMatches++;
+      });
+   }
+   stabbing.stop();
+
+   stabbing.print();
+
+
+   // Stabbing queries (full scan) ------------
+   Performance scan("1K-Stabbing-FullScan");
+
+   size_t scanMatches = 0;
+   scan.start();
+   for (long long point : points) {
+      for (const Interval<long long>& range : ranges) {
+         scanMatches += (range.low <= point && point <= range.high);
+      }
+   }
+   scan.stop();
+
+   scan.print();
+
+   std::cout << treeMatches << " matches (full scan: " << scanMatches << ")" << std::endl;
+
+   return 0;
+}
@@ -0,0 +1,82 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "LsmTree.hh"
+#include "../Utils/performance.hh"
+
+int main() {
+   // Open big file
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "10M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   // Small budget on purpose: the index must spill to disk several times
+   LsmOptions options;
+   options.directory = ".";
+   options.memtableBytes = 32 << 20;
+
+   LsmTree<std::string> index(options);
+   std::string word;
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   // Insertion -------------------------------
+   Performance insertion("10M-LSM-Insertion");
+
+   insertion.start();
+   while (file >> word) {
+      index.insert(word);
+   }
+   insertion.stop();
+
+   insertion.print();
+
+   std::cout << "Runs: " << index.runCount()
+             << ", memtable " << index.memtableBytes() / (1024 * 1024) << " MB"
+             << ", fences + Bloom filters " << index.indexBytes() / 1024 << " KB" << std::endl;
+
+
+   // Search ----------------------------------
+   Performance search("10M-LSM-Search");
+
+   search.start();
+   index.contains("Ayyoub");
+   search.stop();
+
+   search.print();
+
+
+   // Range scan ------------------------------
+   Performance scan("10M-LSM-Scan");
+
+   size_t matches = 0;
+   scan.start();
+   index.scan("a", "b", [&matches](const std::string&) {
+      matches++;
+   });
+   scan.stop();
+
+   scan.print();
+   std::cout << matches << " distinct words in [a, b]" << std::endl;
+
+
+   // Compaction ------------------------------
+   Performance compaction("10M-LSM-Compaction");
+
+   compaction.start();
+   index.compact();
+   compaction.stop();
+
+   compaction.print();
+
+   return 0;
+}
@@ -9,8 +9,24 @@
 #include "RedBlackTree.hh"
 #include "../Utils/performance.hh"
 
+// Word keys share long prefixes, so compare them once per level with std::string::compare
+using WordTree = RedBlackTree<std::string, ThreeWayCompare<std::string>>;
+
+// Print the tree's memory footprint, broken down by source
+void printMemoryUsage(const WordTree& tree) {
+   const MemoryUsage usage = tree.memoryUsage();
+   const size_t MB = 1024 * 1024;
+
+   std::cout << "Memory: " << usage.total() / MB << " MB"
+             << " (nodes " << usage.nodeBytes / MB << " MB"
+             << ", keys " << usage.keyHeapBytes / MB << " MB"
+             << ", allocator slack " << usage.allocatorSlackBytes / MB << " MB)"
+             << " - " << usage.allocations << " allocations, "
+             << usage.deallocations << " deallocations" << std::endl;
+}
+
 int main() {
-   RedBlackTree<std::string> tree;
+   WordTree tree;
    std::string word;
 
 
@@ -58,6 +74,7 @@ int main() {
    insertion1M.stop();
 
    insertion1M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -95,6 +112,7 @@ int main() {
    insertion2M.stop();
 
    insertion2M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -132,6 +150,7 @@ int main() {
    insertion3M.stop();
 
    insertion3M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -169,6 +188,7 @@ int main() {
    insertion4M.stop();
 
    insertion4M.print();
+   printMemoryUsage(tree);
 
    // Search ----------------------------------
    Performance search4M("4M-Search");
@@ -205,6 +225,7 @@ int main() {
    insertion5M.stop();
 
    insertion5M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -242,6 +263,7 @@ int main() {
    insertion6M.stop();
 
    insertion6M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -279,6 +301,7 @@ int main() {
    insertion7M.stop();
 
    insertion7M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -316,6 +339,7 @@ int main() {
    insertion8M.stop();
 
    insertion8M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -353,6 +377,7 @@ int main() {
    insertion9M.stop();
 
    insertion9M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -390,6 +415,7 @@ int main() {
    insertion10M.stop();
 
    insertion10M.print();
+   printMemoryUsage(tree);
 
 
    // Search ----------------------------------
@@ -0,0 +1,169 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "PrefixQuery.hh"
+#include "../Utils/performance.hh"
+
+using WordTree = RedBlackTree<std::string, ThreeWayCompare<std::string>>;
+using RankedWordTree = WeightBalancedTree<std::string, ThreeWayCompare<std::string>>;
+
+int main() {
+   const int COUNT_QUERIES = 100;
+   const int AUTOCOMPLETE_QUERIES = 100000;
+   const size_t TOP_K = 10;
+
+   // Open big file
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "10M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   std::vector<std::string> words;
+   std::string word;
+   while (file >> word) {
+      words.push_back(word);
+   }
+
+   // Prefixes of 1 to 3 characters taken from random words, so most queries match something
+   std::mt19937 random(42);
+   std::vector<std::string> prefixes;
+   for (int i = 0; i < AUTOCOMPLETE_QUERIES; i++) {
+      const std::string& source = words[random() % words.size()];
+      prefixes.push_back(source.substr(0, 1 + random() % 3));
+   }
+
+   std::cout << "---------------------------------------" << std::endl;
+
+   // Insertion -------------------------------
+   WordTree tree;
+   RankedWordTree ranked;
+   AdaptiveRadixTree index;
+
+   Performance treeInsertion("10M-Insertion-Tree");
+   treeInsertion.start();
+   for (const std::string& w : words) {
+      tree.insert(w);
+   }
+   treeInsertion.stop();
+   treeInsertion.print();
+
+   Performance rankedInsertion("10M-Insertion-WeightBalanced");
+   rankedInsertion.start();
+   for (const std::string& w : words) {
+      ranked.insert(w);
+   }
+   rankedInsertion.stop();
+   rankedInsertion.print();
+
+   Performance indexInsertion("10M-Insertion-ART");
+   indexInsertion.start();
+   for (const std::string& w : words) {
+      index.insert(w);
+   }
+   indexInsertion.stop();
+   indexInsertion.print();
+
+   std::cout << "Memory: tree " << tree.memoryUsage().total() / (1024 * 1024) << " MB, ART "
+             << index.memoryBytes() / (1024 * 1024) << " MB" << std::endl;
+   std::cout << "---------------------------------------" << std::endl;
+
+
+   // countPrefix -----------------------------
+   size_t scanTotal = 0, treeTotal = 0, rankedTotal = 0, indexTotal = 0;
+
+   Performance scan("100-CountPrefix-FullScan");
+   scan.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      const std::string& prefix = prefixes[i];
+      tree.inorder([&](const std::string& key) {
+         scanTotal += key.compare(0, prefix.size(), prefix) == 0;
+      });
+   }
+   scan.stop();
+   scan.print();
+
+   Performance bounds("100-CountPrefix-Tree");
+   bounds.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      treeTotal += countPrefix(tree, prefixes[i]);
+   }
+   bounds.stop();
+   bounds.print();
+
+   Performance rank("100-CountPrefix-WeightBalanced");
+   rank.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      rankedTotal += countPrefix(ranked, prefixes[i]);
+   }
+   rank.stop();
+   rank.print();
+
+   Performance radix("100-CountPrefix-ART");
+   radix.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      indexTotal += index.countPrefix(prefixes[i]);
+   }
+   radix.stop();
+   radix.print();
+
+   std::cout << "Matches: scan " << scanTotal << ", tree " << treeTotal << ", weight-balanced "
+             << rankedTotal << ", ART " << indexTotal << std::endl;
+   std::cout << "---------------------------------------" << std::endl;
+
+
+   // First k distinct completions -----------
+   size_t treeHits = 0, indexHits = 0;
+
+   Performance treeTopK("100K-First10-Tree");
+   treeTopK.start();
+   for (const std::string& prefix : prefixes) {
+      visitPrefix(tree, prefix, [&treeHits](const std::string&) { treeHits++; }, TOP_K);
+   }
+   treeTopK.stop();
+   treeTopK.print();
+
+   Performance indexTopK("100K-First10-ART");
+   indexTopK.start();
+   for (const std::string& prefix : prefixes) {
+      index.visitPrefix(prefix, [&indexHits](const std::string&) { indexHits++; }, TOP_K);
+   }
+   indexTopK.stop();
+   indexTopK.print();
+
+   std::cout << "Suggestions: tree " << treeHits << ", ART " << indexHits << std::endl;
+   std::cout << "---------------------------------------" << std::endl;
+
+
+   // Top-k autocomplete (most frequent) ------
+   size_t treeRanked = 0, indexRanked = 0;
+
+   Performance treeFrequent("100-Top10-Frequent-Tree");
+   treeFrequent.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      treeRanked += topCompletions(tree, prefixes[i], TOP_K).size();
+   }
+   treeFrequent.stop();
+   treeFrequent.print();
+
+   Performance indexFrequent("100-Top10-Frequent-ART");
+   indexFrequent.start();
+   for (int i = 0; i < COUNT_QUERIES; i++) {
+      indexRanked += index.topCompletions(prefixes[i], TOP_K).size();
+   }
+   indexFrequent.stop();
+   indexFrequent.print();
+
+   std::cout << "Ranked suggestions: tree " << treeRanked << ", ART " << indexRanked << std::endl;
+
+   return 0;
+}
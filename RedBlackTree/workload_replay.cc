@@ -0,0 +1,222 @@
+/*--------------------------------------------------------------------------------------------------
+ *                       Copyright (c) Ayyoub EL Kouri. All rights reserved
+ *     Becoming an expert won't happen overnight, but with a bit of patience, you'll get there
+ *------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "WorkloadTrace.hh"
+
+// Usage:
+//   workload_replay record <trace> [hashed]   Record a sample workload over 1M_words.txt
+//   workload_replay <trace> [string]          Replay a trace on every tree configuration
+//
+// Replayed keys are the trace's ranks, as integers or as fixed-width hex strings (same order),
+// so a trace recorded on private data can be compared across policies and options.
+
+using Clock = std::chrono::steady_clock;
+
+// Replay keys: ranks or hashes as the tree's key type
+template<typename K>
+K replayKey(uint64_t key);
+
+template<>
+uint64_t replayKey<uint64_t>(uint64_t key) {
+   return key;
+}
+
+template<>
+std::string replayKey<std::string>(uint64_t key) {
+   char text[17];
+   std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(key));
+   return text;
+}
+
+// Latency percentiles of one operation type, in nanoseconds
+void printLatencies(const std::string& op, std::vector<uint64_t>& latencies) {
+   if (latencies.empty()) return;
+
+   std::sort(latencies.begin(), latencies.end());
+   auto percentile = [&latencies](double p) {
+      const size_t index = static_cast<size_t>(p * latencies.size());
+      return latencies[std::min(index, latencies.size() - 1)];
+   };
+
+   std::cout << "   " << op << ": " << latencies.size() << " ops, p50 " << percentile(0.50)
+             << " ns, p90 " << percentile(0.90) << " ns, p99 " << percentile(0.99)
+             << " ns, p99.9 " << percentile(0.999) << " ns, max " << latencies.back() << " ns"
+             << std::endl;
+}
+
+// Run every record of the trace as fast as possible, timing each operation
+template<typename Tree, typename K>
+void replay(const std::string& name, const WorkloadTrace& trace, const std::vector<K>& lows,
+            const std::vector<K>& highs, size_t cacheEntries) {
+   Tree tree;
+   if (cacheEntries != 0) {
+      tree.enableLookupCache(cacheEntries);
+   }
+
+   std::vector<uint64_t> latencies[4];  // Indexed by TraceOp - 1
+   size_t found = 0;
+   size_t scanned = 0;
+
+   const Clock::time_point start = Clock::now();
+   for (size_t i = 0; i < trace.records.size(); i++) {
+      const TraceOp op = trace.records[i].op;
+      const Clock::time_point before = Clock::now();
+
+      switch (op) {
+         case TraceOp::INSERT:
+            tree.insert(lows[i]);
+            break;
+         case TraceOp::REMOVE:
+            found += tree.remove(lows[i]);
+            break;
+         case TraceOp::CONTAINS:
+            found += tree.contains(lows[i]);
+            break;
+         default:
+            tree.inorderRange(lows[i], highs[i], [&scanned](const K&) { scanned++; });
+            break;
+      }
+
+      const auto elapsed = Clock::now() - before;
+      latencies[static_cast<int>(op) - 1].push_back(static_cast<uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+   }
+   const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+   std::cout << name << ": " << seconds * 1000 << " ms, "
+             << static_cast<size_t>(trace.records.size() / seconds) << " ops/s ("
+             << found << " hits, " << scanned << " keys scanned, final size " << tree.size()
+             << ")" << std::endl;
+   if (cacheEntries != 0) {
+      std::cout << "   lookup cache: " << tree.cacheHitCount() << " hits, "
+                << tree.cacheMissCount() << " misses" << std::endl;
+   }
+
+   printLatencies("insert", latencies[0]);
+   printLatencies("remove", latencies[1]);
+   printLatencies("contains", latencies[2]);
+   printLatencies("range", latencies[3]);
+}
+
+// Every balancing policy, without and with the lookup cache
+template<typename K>
+void replayAll(const WorkloadTrace& trace) {
+   const size_t CACHE_ENTRIES = 4096;
+
+   // Build keys up front so string formatting stays out of the timings
+   std::vector<K> lows;
+   std::vector<K> highs;
+   lows.reserve(trace.records.size());
+   highs.reserve(trace.records.size());
+   for (const TraceRecord& record : trace.records) {
+      lows.push_back(replayKey<K>(record.key));
+      highs.push_back(replayKey<K>(record.high));
+   }
+
+   std::cout << "---------------------------------------" << std::endl;
+   replay<RedBlackTree<K>>("RedBlack", trace, lows, highs, 0);
+   replay<RedBlackTree<K>>("RedBlack+Cache", trace, lows, highs, CACHE_ENTRIES);
+   std::cout << "---------------------------------------" << std::endl;
+   replay<AvlTree<K>>("AVL", trace, lows, highs, 0);
+   replay<AvlTree<K>>("AVL+Cache", trace, lows, highs, CACHE_ENTRIES);
+   std::cout << "---------------------------------------" << std::endl;
+   replay<WeightBalancedTree<K>>("WeightBalanced", trace, lows, highs, 0);
+   replay<WeightBalancedTree<K>>("WeightBalanced+Cache", trace, lows, highs, CACHE_ENTRIES);
+   std::cout << "---------------------------------------" << std::endl;
+}
+
+// Sample capture: skewed reads with some churn and short ranges over the word file
+int record(const std::string& tracePath, TraceKeys mode) {
+   const size_t OPERATIONS = 2000000;
+   const size_t HOT_WORDS = 1000;
+
+   std::string path = "../Utils/big_files_for_benchmarking/";
+   std::ifstream file(path + "1M_words.txt");
+
+   if (!file.is_open()) {
+      std::cerr << "Error opening file." << std::endl;
+      return 1;
+   }
+
+   std::vector<std::string> words;
+   std::string word;
+   while (file >> word) {
+      words.push_back(word);
+   }
+
+   RecordingTree<std::string, ThreeWayCompare<std::string>> tree(tracePath, mode);
+   if (!tree.isOpen()) {
+      std::cerr << "Error creating " << tracePath << std::endl;
+      return 1;
+   }
+
+   // Three lookups in four go to a small hot set
+   std::mt19937 random(42);
+   for (size_t i = 0; i < OPERATIONS; i++) {
+      const size_t range = (random() % 4 != 0) ? std::min(HOT_WORDS, words.size()) : words.size();
+      const std::string& key = words[random() % range];
+      const unsigned kind = random() % 100;
+
+      if (kind < 30) {
+         tree.insert(key);
+      } else if (kind < 40) {
+         tree.remove(key);
+      } else if (kind < 98) {
+         tree.contains(key);
+      } else {
+         // Short range: the word and the words it is a prefix of
+         tree.inorderRange(key, key + "\x7f", [](const std::string&) {});
+      }
+   }
+
+   if (!tree.close()) {
+      std::cerr << "Error writing " << tracePath << std::endl;
+      return 1;
+   }
+   std::cout << tree.recordedOperations() << " operations recorded to " << tracePath << std::endl;
+   return 0;
+}
+
+int main(int argc, char* argv[]) {
+   if (argc >= 3 && std::string(argv[1]) == "record") {
+      const bool hashed = argc >= 4 && std::string(argv[3]) == "hashed";
+      return record(argv[2], hashed ? TraceKeys::HASHED : TraceKeys::SYNTHETIC);
+   }
+
+   if (argc < 2) {
+      std::cerr << "Usage: " << argv[0] << " record <trace> [hashed]" << std::endl
+                << "       " << argv[0] << " <trace> [string]" << std::endl;
+      return 1;
+   }
+
+   WorkloadTrace trace;
+   if (!loadTrace(argv[1], trace)) {
+      std::cerr << "Error reading trace " << argv[1] << std::endl;
+      return 1;
+   }
+
+   const double span = trace.records.empty() ? 0 : trace.records.back().time / 1e9;
+   std::cout << trace.records.size() << " operations over " << span << " s as recorded";
+   if (trace.keys == TraceKeys::SYNTHETIC) {
+      std::cout << ", " << trace.distinctKeys << " distinct keys" << std::endl;
+   } else {
+      std::cout << ", hashed keys (ranges are not meaningful)" << std::endl;
+   }
+
+   if (argc >= 3 && std::string(argv[2]) == "string") {
+      replayAll<std::string>(trace);
+   } else {
+      replayAll<uint64_t>(trace);
+   }
+   return 0;
+}